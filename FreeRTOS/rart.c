@@ -0,0 +1,816 @@
+/**
+ * @file rart.c
+ * @author Matheus T. dos Santos (tenoriomatheus0@gmail.com)
+ * @brief Backend of RART for the FreeRTOS
+ * @version 0.1
+ * @date 16/10/2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Every kernel object is statically allocated, so FreeRTOSConfig.h must set
+ * configSUPPORT_STATIC_ALLOCATION, configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall
+ * to 1. The heap uses pvPortMalloc, usually provided by heap_4.
+ */
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+#include "task.h"
+#include "timers.h"
+
+#include "rart-defines.h"
+#include "rart.h"
+
+/*
+ * Pool sizes. Each one can be set by the resource manifest of gen_files.py in
+ * rart-defines.h, otherwise it is derived from the number of tasks.
+ */
+
+/**
+ * @brief Number of the mutexes
+ */
+#ifndef NUM_OF_MUTEXES
+#define NUM_OF_MUTEXES (7 * NUM_OF_TASKS)
+#endif
+
+/**
+ * @brief Number of the message queues
+ */
+#ifndef NUM_OF_MSGQ
+#define NUM_OF_MSGQ (4 * NUM_OF_TASKS)
+#endif
+
+/**
+ * @brief Depth of each message queue. It does not grow with the number of tasks, so the
+ * queue storage stays linear in the number of queues.
+ */
+#ifndef NUM_OF_MSG_ITENS
+#define NUM_OF_MSG_ITENS 8
+#endif
+
+/**
+ * @brief Maximum size of the message queue item
+ */
+#ifndef MSG_ITEM_SIZE
+#define MSG_ITEM_SIZE 8
+#endif
+
+/**
+ * @brief Number of the timers
+ */
+#ifndef NUM_OF_TIMERS
+#define NUM_OF_TIMERS NUM_OF_TASKS
+#endif
+
+/**
+ * @brief Invalid index
+ */
+#define INVALID_INDEX ((rart_index_t) -1)
+
+/**
+ * @brief Hook called for each scheduling event when CONFIG_RART_TRACING is set. Define
+ * it in FreeRTOSConfig.h to forward the events to the trace recorder.
+ */
+#ifndef traceRART_EVENT
+#define traceRART_EVENT(event, arg0, arg1)
+#endif
+
+/**
+ * @brief Type of the index used in this lib. It is as narrow as the largest pool
+ * allows, the all-ones value being reserved for INVALID_INDEX.
+ */
+#if NUM_OF_MUTEXES > 254 || NUM_OF_MSGQ > 254 || NUM_OF_TIMERS > 254
+typedef uint16_t rart_index_t;
+#else
+typedef uint8_t rart_index_t;
+#endif
+
+_Static_assert(NUM_OF_MUTEXES < UINT16_MAX && NUM_OF_MSGQ < UINT16_MAX
+                       && NUM_OF_TIMERS < UINT16_MAX,
+               "Pools are limited to 65534 objects");
+
+/**
+ * @brief Struct with global variables of the RART-c. Every field starts as zero, so the
+ * struct is kept in .bss and is neither stored in flash nor copied at boot.
+ */
+static struct rart_fields {
+    struct {
+        StaticSemaphore_t buffer;  /**< FreeRTOS mutex storage */
+        SemaphoreHandle_t handle;  /**< FreeRTOS mutex. */
+        bool is_used;              /**< Flag to check if the mutex is in use */
+    } mutexes[NUM_OF_MUTEXES];     /**< List of mutexes */
+    struct {
+        struct {
+            uint8_t buffer[NUM_OF_MSG_ITENS * MSG_ITEM_SIZE]; /**< Message queue storage */
+            StaticQueue_t queue;  /**< FreeRTOS queue storage */
+            QueueHandle_t handle; /**< FreeRTOS queue */
+        } instance[NUM_OF_MSGQ];  /**< List of Message Queues */
+        rart_index_t index;       /**< Number of message queues handed out */
+    } msgq;                       /**< Message queue sub-struct */
+    struct {
+        const void
+                *state; /**< Reference to state that will be sent in the timer callback. */
+        rart_timer_callback_t callback; /**< Timer callback */
+        StaticTimer_t buffer;           /**< FreeRTOS timer storage */
+        TimerHandle_t handle;           /**< FreeRTOS software timer */
+        TickType_t deadline;            /**< Tick of the next period of a periodic timer */
+        uint32_t remainder;             /**< Fraction of tick of the deadline, in 1/1000 */
+        uint32_t period;                /**< Period in milliseconds, 0 if one-shot */
+        uint32_t missed;                /**< Periods of a periodic timer expired late */
+        uint32_t epoch;                 /**< Stops of the timer, so an expiry never re-arms a
+                                             later owner */
+        rart_timer_missed_policy_t policy; /**< Missed-tick policy of a periodic timer */
+        bool is_used;                   /**< Flag to check if the timer is in use */
+        bool is_stopped;                /**< Flag set by a stop until the timer task releases
+                                             the timer */
+    } timers[NUM_OF_TIMERS];            /**< List of timers */
+} self;
+
+/**
+ * @brief Stored runtime log level of a module never set, which uses CONFIG_RART_LOG_LEVEL.
+ * The other values are the level plus one, so the array starts as zero and is kept in
+ * .bss.
+ */
+#define LOG_LEVEL_DEFAULT 0
+
+/**
+ * @brief Runtime log level of each module, LOG_LEVEL_DEFAULT or the level plus one
+ */
+static uint8_t log_levels[RART_LOG_MODULE_COUNT];
+
+/**
+ * @brief Search the next timer free
+ *
+ * @return rart_index_t Index of the next free timer
+ */
+static rart_index_t search_free_timer();
+
+/**
+ * @brief Search a timer by its handle
+ *
+ * @param timer[in] Handle of the timer
+ * @return rart_index_t Index of the timer, INVALID_INDEX if it is not in the pool.
+ */
+static rart_index_t search_timer(TimerHandle_t timer);
+
+/**
+ * @brief Search the next free mutex
+ *
+ * @return rart_index_t Index of the next free mutex
+ */
+static rart_index_t search_free_mutex();
+
+/**
+ * @brief Search the mutex by its handle
+ *
+ * @param mutex[in] Mutex handle
+ * @return rart_index_t Index of the mutex.
+ */
+static rart_index_t search_mutex(SemaphoreHandle_t mutex);
+
+/**
+ * @brief Get the index of a message queue by its handle
+ *
+ * @param msgq[in] Message queue handle
+ * @return rart_index_t Index of the message queue.
+ */
+static rart_index_t msgq_index(QueueHandle_t msgq);
+
+/**
+ * @brief Convert a timeout in milliseconds to ticks
+ *
+ * @param timeout Timeout in milliseconds
+ * @return TickType_t Timeout in ticks
+ */
+static TickType_t ms_to_ticks(uint32_t timeout);
+
+/**
+ * @brief Callback called when FreeRTOS timer expire
+ *
+ * @param timer[in] Handle of the expired timer
+ */
+static void default_callback(TimerHandle_t timer);
+
+/**
+ * @brief Arm a periodic timer for its next period, applying its missed-tick policy
+ *
+ * @param idx Index of the periodic timer
+ */
+static void timer_periodic_arm(rart_index_t idx);
+
+/**
+ * @brief Stop a periodic timer and release it, run by the timer task after the
+ * callbacks and commands queued before the stop
+ *
+ * @param param Unused
+ * @param idx Index of the stopped timer
+ */
+static void timer_periodic_release(void *param, uint32_t idx);
+
+/**
+ * @brief Get the wait of a timer command. The timer task must not block on its own
+ * command queue.
+ *
+ * @return TickType_t Wait of the timer command
+ */
+static TickType_t timer_command_wait();
+
+/**
+ * @brief Print a formatted string prefixed by the level tag
+ *
+ * @param level Level of the message
+ * @param format Formatted string
+ * @param va Variable arguments
+ */
+static void log_vprint(uint8_t level, const char *format, va_list va);
+
+#if defined(CONFIG_RART_TRACING)
+void rart_trace_event(rart_trace_event_t event, uint32_t arg0, uint32_t arg1) {
+    traceRART_EVENT(event, arg0, arg1);
+}
+#endif
+
+void rtos_trace_poll_start(uint32_t task) {
+    RART_TRACE(RART_TRACE_POLL_START, task, 0);
+}
+
+void rtos_trace_poll_end(uint32_t task) {
+    RART_TRACE(RART_TRACE_POLL_END, task, 0);
+}
+
+void rart_log_print(uint8_t level, const char *format, ...) {
+    va_list va;
+    va_start(va, format);
+    log_vprint(level, format, va);
+    va_end(va);
+}
+
+void rtos_log_level_set(uint32_t module, uint8_t level) {
+    if (module >= RART_LOG_MODULE_COUNT) {
+        return;
+    }
+
+    /* Clamped, so the stored value never wraps to LOG_LEVEL_DEFAULT */
+    log_levels[module] = ((level > RART_LOG_LEVEL_DBG) ? RART_LOG_LEVEL_DBG : level) + 1;
+}
+
+uint8_t rtos_log_level_get(uint32_t module) {
+    if (module >= RART_LOG_MODULE_COUNT) {
+        return RART_LOG_LEVEL_NONE;
+    }
+
+    if (log_levels[module] == LOG_LEVEL_DEFAULT) {
+        return CONFIG_RART_LOG_LEVEL;
+    }
+
+    return log_levels[module] - 1;
+}
+
+/**
+ * @brief Print a formatted string with background red
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void print_error(const char *format, ...) {
+#if RART_LOG_LEVEL_ERR <= CONFIG_RART_LOG_LEVEL
+    if (!RART_LOG_ENABLED(RART_LOG_MODULE_RUST, RART_LOG_LEVEL_ERR)) {
+        return;
+    }
+
+    va_list va;
+    va_start(va, format);
+    log_vprint(RART_LOG_LEVEL_ERR, format, va);
+    va_end(va);
+#endif
+}
+
+/**
+ * @brief Print a formatted string in purple
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void log_fn(const char *format, ...) {
+#if RART_LOG_LEVEL_INF <= CONFIG_RART_LOG_LEVEL
+    if (!RART_LOG_ENABLED(RART_LOG_MODULE_RUST, RART_LOG_LEVEL_INF)) {
+        return;
+    }
+
+    va_list va;
+    va_start(va, format);
+    log_vprint(RART_LOG_LEVEL_INF, format, va);
+    va_end(va);
+#endif
+}
+
+/**
+ * @brief Print the filename and line in cyan
+ *
+ * @param file[in] The filename
+ * @param line The line
+ */
+void trace_fn(const char *file, uint32_t line) {
+    RART_LOG_DBG(RART_LOG_MODULE_RUST, "%s:%d\n", file, line);
+}
+
+/**
+ * @brief Get the current timestamp
+ *
+ * @return uint32_t Current timestamp
+ */
+uint32_t timestamp() {
+    return xTaskGetTickCount() / configTICK_RATE_HZ;
+}
+
+/**
+ * @brief Get the current timestamp, in milliseconds
+ *
+ * @return uint32_t Current timestamp, in milliseconds
+ */
+uint32_t timestamp_millis() {
+    return ((uint64_t) xTaskGetTickCount() * 1000) / configTICK_RATE_HZ;
+}
+
+/**
+ * @brief Print a formatted string in red and stay on the infinite loop
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void panic(const char *format, ...) {
+    printf("[panic]");
+    va_list va;
+    va_start(va, format);
+    vprintf(format, va);
+    va_end(va);
+
+    taskDISABLE_INTERRUPTS();
+    while (1);
+}
+
+/**
+ * @brief Get a new FreeRTOS mutex in the list
+ *
+ * @return void* FreeRTOS mutex C reference
+ */
+void *rtos_mutex_new() {
+    rart_index_t idx = search_free_mutex();
+
+    if (idx == INVALID_INDEX) {
+        RART_LOG_ERR(RART_LOG_MODULE_MUTEX, "No mutex available\n");
+        return NULL;
+    }
+
+    return self.mutexes[idx].handle;
+}
+
+/**
+ * @brief Free a FreeRTOS mutex used
+ *
+ * @param mutex[in] FreeRTOS mutex C reference
+ */
+void rtos_mutex_del(void *mutex) {
+    rart_index_t idx = search_mutex(mutex);
+
+    if (idx == INVALID_INDEX) {
+        return;
+    }
+
+    self.mutexes[idx].is_used = false;
+}
+
+/**
+ * @brief Lock a FreeRTOS mutex
+ *
+ * @param mutex[in] FreeRTOS mutex C reference
+ * @param timeout Timeout of mutex lock operation
+ * @return int32_t 0 if success, -EBUSY if the mutex is busy and timeout is zero,
+ * -EAGAIN if the timeout expired.
+ */
+int32_t rtos_mutex_lock(void *mutex, uint32_t timeout) {
+    if (xSemaphoreTakeRecursive(mutex, ms_to_ticks(timeout)) == pdTRUE) {
+        return 0;
+    }
+
+    return (timeout == 0) ? -EBUSY : -EAGAIN;
+}
+
+/**
+ * @brief Unlock a FreeRTOS mutex
+ *
+ * @param mutex FreeRTOS mutex C reference
+ * @return int32_t 0 if success, -EPERM if the caller does not hold the mutex.
+ */
+int32_t rtos_mutex_unlock(void *mutex) {
+    return (xSemaphoreGiveRecursive(mutex) == pdTRUE) ? 0 : -EPERM;
+}
+
+int32_t rtos_mutex_stats_get(uint32_t idx, rart_mutex_stats_t *stats) {
+    (void) idx;
+    (void) stats;
+
+    return -ENOTSUP;
+}
+
+void rtos_mutex_stats_reset(void) {
+}
+
+int32_t rtos_pool_stats_get(rart_pool_id_t pool, rart_pool_stats_t *stats) {
+    (void) pool;
+    (void) stats;
+
+    return -ENOTSUP;
+}
+
+/**
+ * @brief Get a new FreeRTOS queue in the list. A queue is never handed out twice, since
+ * its owner may still use it or have tasks blocked on it, see rart.h.
+ *
+ * @param data_size Item size of the message queue
+ * @return void* FreeRTOS queue C reference, NULL if the item size is not supported or
+ * every queue was handed out.
+ */
+void *rtos_msgq_new(size_t data_size) {
+    if (data_size > MSG_ITEM_SIZE) {
+        RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "Message queue item too big\n");
+        return NULL;
+    }
+
+    taskENTER_CRITICAL();
+    rart_index_t idx = self.msgq.index;
+    if (idx < NUM_OF_MSGQ) {
+        self.msgq.index++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (idx >= NUM_OF_MSGQ) {
+        RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "No message queue available\n");
+        return NULL;
+    }
+
+    self.msgq.instance[idx].handle =
+            xQueueCreateStatic(NUM_OF_MSG_ITENS, data_size, self.msgq.instance[idx].buffer,
+                               &self.msgq.instance[idx].queue);
+
+    return self.msgq.instance[idx].handle;
+}
+
+/**
+ * @brief Send the data to a FreeRTOS queue
+ *
+ * @param msgq[in] FreeRTOS queue C reference
+ * @param data[in] Reference to the data
+ * @param timeout Timeout of the send operation
+ * @return int32_t 0 if success, -ENOMSG if the queue is full and timeout is zero,
+ * -EAGAIN if the timeout expired.
+ */
+int32_t rtos_msgq_send(void *msgq, const void *data, uint32_t timeout) {
+    if (xQueueSend(msgq, data, ms_to_ticks(timeout)) != pdTRUE) {
+        return (timeout == 0) ? -ENOMSG : -EAGAIN;
+    }
+
+    RART_TRACE(RART_TRACE_WAKE_MSGQ, msgq_index(msgq), uxQueueMessagesWaiting(msgq));
+
+    return 0;
+}
+
+/**
+ * @brief Receive the data from a FreeRTOS queue
+ *
+ * @param msgq[in] FreeRTOS queue C reference
+ * @param data_out[out] Address of the out data
+ * @param timeout Timeout of the receive operation.
+ * @return int32_t 0 if success, -ENOMSG if the queue is empty and timeout is zero,
+ * -EAGAIN if the timeout expired.
+ */
+int32_t rtos_msgq_recv(void *msgq, void *data_out, uint32_t timeout) {
+    if (xQueueReceive(msgq, data_out, ms_to_ticks(timeout)) != pdTRUE) {
+        return (timeout == 0) ? -ENOMSG : -EAGAIN;
+    }
+
+    return 0;
+}
+
+int32_t rtos_msgq_stats_get(uint32_t idx, rart_msgq_stats_t *stats) {
+    (void) idx;
+    (void) stats;
+
+    return -ENOTSUP;
+}
+
+void rtos_msgq_stats_reset(void) {
+}
+
+/**
+ * @brief Initialize all FreeRTOS timers
+ */
+void rtos_timer_init() {
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        self.timers[i].is_used = false;
+        self.timers[i].handle  = xTimerCreateStatic("rart", 1, pdFALSE,
+                                                    (void *) (uintptr_t) i,
+                                                    default_callback,
+                                                    &self.timers[i].buffer);
+    }
+}
+
+/**
+ * @brief Schedule a free timer
+ *
+ * @param callback[in] User callback called inside FreeRTOS timer callback
+ * @param state[in] Context passed to user callback
+ * @param timeout Timer time to expire
+ */
+void rtos_timer_reschedule(rart_timer_callback_t callback, const void *state,
+                           uint32_t timeout) {
+    rart_index_t idx = search_free_timer();
+
+    if (idx == INVALID_INDEX) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "No timer available\n");
+        while (1);
+    }
+    self.timers[idx].callback = callback;
+    self.timers[idx].state    = state;
+    self.timers[idx].period   = 0;
+
+    /* A FreeRTOS timer period cannot be zero, the shortest one is a tick */
+    TickType_t ticks = ms_to_ticks(timeout);
+
+    xTimerChangePeriod(self.timers[idx].handle, (ticks == 0) ? 1 : ticks,
+                       timer_command_wait());
+}
+
+void *rtos_timer_periodic_start(rart_timer_callback_t callback, const void *state,
+                                uint32_t period, rart_timer_missed_policy_t policy) {
+    if (period == 0 || policy > RART_TIMER_MISSED_DELAY) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "Invalid periodic timer\n");
+        return NULL;
+    }
+
+    rart_index_t idx = search_free_timer();
+
+    if (idx == INVALID_INDEX) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "No timer available\n");
+        return NULL;
+    }
+    self.timers[idx].callback  = callback;
+    self.timers[idx].state     = state;
+    self.timers[idx].period    = period;
+    self.timers[idx].policy    = policy;
+    self.timers[idx].missed    = 0;
+    self.timers[idx].deadline  = xTaskGetTickCount();
+    self.timers[idx].remainder = 0;
+
+    timer_periodic_arm(idx);
+
+    return self.timers[idx].handle;
+}
+
+void rtos_timer_periodic_stop(void *timer) {
+    rart_index_t idx = search_timer(timer);
+
+    if (idx == INVALID_INDEX) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    bool is_running = (self.timers[idx].period != 0);
+    if (is_running) {
+        self.timers[idx].period     = 0;
+        self.timers[idx].is_stopped = true;
+        self.timers[idx].epoch++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (!is_running) {
+        return;
+    }
+
+    /* Released by the timer task, so a callback running or an expiry pending there can
+     * neither re-arm the timer nor reach the next owner of the slot */
+    if (xTimerPendFunctionCall(timer_periodic_release, NULL, idx, timer_command_wait())
+        != pdPASS) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "Timer %u not released\n", idx);
+    }
+}
+
+uint32_t rtos_timer_periodic_missed(void *timer) {
+    rart_index_t idx = search_timer(timer);
+
+    return (idx == INVALID_INDEX) ? 0 : self.timers[idx].missed;
+}
+
+/**
+ * @brief Alloc a memory chunk in the heap
+ *
+ * The chunk is carved from a pvPortMalloc block large enough to honor the alignment.
+ * The address of the block is stored right before the chunk to be released later.
+ *
+ * @param align Align of the memory chunk
+ * @param bytes Number of bytes of the memory chunk
+ * @return void* Memory Address
+ */
+const void *heap_alloc(size_t align, size_t bytes) {
+    if (align < sizeof(void *)) {
+        align = sizeof(void *);
+    }
+
+    uint8_t *block = pvPortMalloc(bytes + align + sizeof(void *));
+    if (block == NULL) {
+        RART_LOG_ERR(RART_LOG_MODULE_HEAP, "Allocation error\n");
+        while (1);
+    }
+
+    uintptr_t ptr = ((uintptr_t) block + sizeof(void *) + align - 1) & ~(align - 1);
+    ((void **) ptr)[-1] = block;
+
+    return (const void *) ptr;
+}
+
+/**
+ * @brief Dealloc a memory chunk in the heap
+ *
+ * @param mem Memory address
+ */
+void heap_free(const void *mem) {
+    if (mem == NULL) {
+        return;
+    }
+
+    vPortFree(((void *const *) mem)[-1]);
+}
+
+static rart_index_t search_free_mutex() {
+    rart_index_t idx = INVALID_INDEX;
+
+    /* Claimed in a critical section, the tasks of every priority take mutexes */
+    taskENTER_CRITICAL();
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        if (!self.mutexes[i].is_used) {
+            self.mutexes[i].is_used = true;
+            idx                     = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (idx != INVALID_INDEX && self.mutexes[idx].handle == NULL) {
+        self.mutexes[idx].handle =
+                xSemaphoreCreateRecursiveMutexStatic(&self.mutexes[idx].buffer);
+    }
+
+    return idx;
+}
+
+static rart_index_t search_mutex(SemaphoreHandle_t mutex) {
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        if (self.mutexes[i].handle == mutex) {
+            return i;
+        }
+    }
+
+    return INVALID_INDEX;
+}
+
+static rart_index_t msgq_index(QueueHandle_t msgq) {
+    /* The handle of a static queue is the address of its StaticQueue_t */
+    return ((uint8_t *) msgq - (uint8_t *) &self.msgq.instance[0].queue)
+           / sizeof(self.msgq.instance[0]);
+}
+
+static TickType_t ms_to_ticks(uint32_t timeout) {
+    return (TickType_t) (((uint64_t) timeout * configTICK_RATE_HZ + 999) / 1000);
+}
+
+static void default_callback(TimerHandle_t timer) {
+    rart_index_t idx = (rart_index_t) (uintptr_t) pvTimerGetTimerID(timer);
+
+    if (idx >= NUM_OF_TIMERS) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "Invalid index\n");
+        while (1);
+    }
+
+    taskENTER_CRITICAL();
+    bool is_stopped = self.timers[idx].is_stopped;
+    bool periodic   = (self.timers[idx].period != 0);
+    uint32_t epoch  = self.timers[idx].epoch;
+    taskEXIT_CRITICAL();
+
+    /* Expired before its stop reached the timer task, which releases it */
+    if (is_stopped) {
+        return;
+    }
+
+    RART_TRACE(RART_TRACE_WAKE_TIMER, idx, self.timers[idx].state);
+
+    self.timers[idx].callback(self.timers[idx].state);
+
+    if (!periodic) {
+        self.timers[idx].is_used = false;
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    bool is_rearmed = (self.timers[idx].period != 0 && self.timers[idx].epoch == epoch);
+    taskEXIT_CRITICAL();
+
+    /* The release of a stop after this check stops the timer after this command */
+    if (is_rearmed) {
+        timer_periodic_arm(idx);
+    }
+}
+
+static void timer_periodic_arm(rart_index_t idx) {
+    TickType_t now  = xTaskGetTickCount();
+    uint32_t missed = 0;
+    bool is_late;
+
+    /* The deadline keeps the fraction of tick of each period, so it does not drift */
+    do {
+        uint64_t step = (uint64_t) self.timers[idx].period * configTICK_RATE_HZ
+                        + self.timers[idx].remainder;
+
+        self.timers[idx].deadline += (TickType_t) (step / 1000);
+        self.timers[idx].remainder = step % 1000;
+
+        /* Tick counts wrap, the deadline is late when it is less than half a range behind */
+        is_late = self.timers[idx].deadline != now
+                  && (TickType_t) (now - self.timers[idx].deadline) < portMAX_DELAY / 2;
+        missed += is_late;
+    } while (is_late && self.timers[idx].policy != RART_TIMER_MISSED_BURST);
+
+    self.timers[idx].missed += missed;
+    if (missed != 0 && self.timers[idx].policy == RART_TIMER_MISSED_DELAY) {
+        self.timers[idx].deadline  = now + ms_to_ticks(self.timers[idx].period);
+        self.timers[idx].remainder = 0;
+    }
+
+    /* A FreeRTOS timer period cannot be zero, a late period expires on the next tick */
+    TickType_t ticks = is_late ? 0 : (TickType_t) (self.timers[idx].deadline - now);
+
+    xTimerChangePeriod(self.timers[idx].handle, (ticks == 0) ? 1 : ticks,
+                       timer_command_wait());
+}
+
+static void timer_periodic_release(void *param, uint32_t idx) {
+    (void) param;
+
+    xTimerStop(self.timers[idx].handle, 0);
+
+    taskENTER_CRITICAL();
+    self.timers[idx].is_stopped = false;
+    self.timers[idx].is_used    = false;
+    taskEXIT_CRITICAL();
+}
+
+static rart_index_t search_timer(TimerHandle_t timer) {
+    if (timer == NULL) {
+        return INVALID_INDEX;
+    }
+
+    rart_index_t idx = (rart_index_t) (uintptr_t) pvTimerGetTimerID(timer);
+
+    return (idx < NUM_OF_TIMERS && self.timers[idx].handle == timer) ? idx : INVALID_INDEX;
+}
+
+static TickType_t timer_command_wait() {
+    return (xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle()) ? 0
+                                                                              : portMAX_DELAY;
+}
+
+static rart_index_t search_free_timer() {
+    rart_index_t idx = INVALID_INDEX;
+
+    /* Claimed in a critical section, the timer task releases timers concurrently */
+    taskENTER_CRITICAL();
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        if (!self.timers[i].is_used) {
+            self.timers[i].is_used = true;
+            idx                    = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return idx;
+}
+
+static void log_vprint(uint8_t level, const char *format, va_list va) {
+    static const char *const tags[] = {
+            [RART_LOG_LEVEL_NONE] = "",
+            [RART_LOG_LEVEL_ERR]  = "[err]",
+            [RART_LOG_LEVEL_WRN]  = "[wrn]",
+            [RART_LOG_LEVEL_INF]  = "[log]",
+            [RART_LOG_LEVEL_DBG]  = "[trace]",
+    };
+
+    printf("%s", tags[level <= RART_LOG_LEVEL_DBG ? level : RART_LOG_LEVEL_NONE]);
+    vprintf(format, va);
+}
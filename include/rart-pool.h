@@ -0,0 +1,399 @@
+/**
+ * @file rart-pool.h
+ * @brief Fixed-size object pools shared by the Zephyr backends
+ * @version 0.1
+ *
+ * A pool is an array of objects and a bitmap of the ones in use. Allocation claims the
+ * first free bit with a compare-and-swap, so it is O(1) per bitmap word and lock-free.
+ * Each pool keeps usage statistics. A pool can also fall back to an allocator when it
+ * is exhausted, and can count generations to detect stale handles. Objects of the
+ * allocator are kept in a list of the pool, so they can be told apart from foreign
+ * pointers.
+ *
+ * The pools are built on the Zephyr atomic bitmaps, so only the Zephyr and zbus backends
+ * use them. The posix and FreeRTOS backends keep their own pools and report no pool
+ * statistics.
+ *
+ * @code
+ * RART_POOL_DEFINE(timer_pool, struct rart_timer, NUM_OF_TIMERS);
+ * RART_POOL_DEFINE(sub_pool, struct sub, 8, RART_POOL_GENERATIONS(8));
+ * @endcode
+ */
+
+#ifndef RART_POOL_H
+#define RART_POOL_H
+
+#include <zephyr.h>
+
+#include "rart.h"
+
+/**
+ * @brief Object of the overflow allocator, with its link in the list of its pool. The
+ * allocator gets and releases the node, the users of the pool see only the object.
+ */
+struct rart_pool_node {
+    sys_snode_t node;  /**< Link in the overflow list of the pool */
+    uint32_t id;       /**< Identifier of the object, from the pool size upward */
+    uint64_t object[]; /**< Object, aligned for any of its fields */
+};
+
+/**
+ * @brief Pool of objects, defined with RART_POOL_DEFINE
+ */
+struct rart_pool {
+    atomic_t *used;        /**< Bitmap of the objects in use */
+    void *objects;         /**< Storage of the objects */
+    size_t object_size;    /**< Size of each object */
+    size_t size;           /**< Number of objects */
+    uint8_t *generation;   /**< Generation of each object, NULL if not tracked */
+    void *(*overflow_alloc)(size_t size); /**< Allocator used when exhausted, or NULL */
+    void (*overflow_free)(void *obj);     /**< Release of the overflow allocator */
+    sys_slist_t overflow_list;            /**< Objects of the allocator in use */
+    struct k_spinlock overflow_lock;      /**< Lock of overflow_list */
+    atomic_t in_use;       /**< Objects of the pool in use */
+    atomic_t peak;         /**< Highest number of objects in use */
+    atomic_t exhausted;    /**< Allocations that found the pool exhausted */
+    atomic_t overflowed;   /**< Allocations served by the overflow allocator */
+};
+
+/**
+ * @brief Define a pool and its storage. The objects are in name##_objects and start as
+ * zero.
+ *
+ * @param name Name of the pool
+ * @param type Type of the objects
+ * @param count Number of objects, up to 65535
+ * @param ... Options: RART_POOL_GENERATIONS and RART_POOL_OVERFLOW
+ */
+#define RART_POOL_DEFINE(name, type, count, ...)                                         \
+    static type name##_objects[count];                                                   \
+    static ATOMIC_DEFINE(name##_used, count);                                            \
+    static struct rart_pool name = {                                                     \
+            .used        = name##_used,                                                  \
+            .objects     = name##_objects,                                               \
+            .object_size = sizeof(type),                                                 \
+            .size        = (count),                                                      \
+            __VA_ARGS__}
+
+/**
+ * @brief Option of RART_POOL_DEFINE to track a generation per object, so handles made
+ * with rart_pool_handle are refused once their object is released
+ */
+#define RART_POOL_GENERATIONS(count) .generation = (uint8_t[count]){0},
+
+/**
+ * @brief Option of RART_POOL_DEFINE to allocate objects with alloc_fn when the pool is
+ * exhausted, and to release them with free_fn. alloc_fn gets the size of a
+ * struct rart_pool_node with its object, and returns the node with the object zeroed or
+ * ready to be used again.
+ */
+#define RART_POOL_OVERFLOW(alloc_fn, free_fn)                                            \
+    .overflow_alloc = (alloc_fn), .overflow_free = (free_fn),
+
+/**
+ * @brief Claim the first free slot of a bitmap. A set bit is a used slot. The slot is
+ * taken with a compare-and-swap on its word, so concurrent claims from other tasks,
+ * cores or interrupts never return the same slot and never block each other.
+ *
+ * @param bitmap[in,out] Bitmap defined with ATOMIC_DEFINE
+ * @param bits Number of slots of the bitmap
+ * @return int Index of the claimed slot, -1 if every slot is used.
+ */
+static inline int rart_bitmap_claim(atomic_t *bitmap, size_t bits) {
+    for (size_t word = 0; word < ATOMIC_BITMAP_SIZE(bits); ++word) {
+        atomic_val_t used = atomic_get(&bitmap[word]);
+
+        while (~used != 0) {
+            int bit    = __builtin_ctzl((unsigned long) ~used);
+            size_t idx = word * ATOMIC_BITS + bit;
+
+            if (idx >= bits) {
+                break;
+            }
+
+            /* Unsigned, since shifting into the sign bit of atomic_val_t is undefined */
+            unsigned long claimed = (unsigned long) used | (1UL << bit);
+
+            if (atomic_cas(&bitmap[word], used, (atomic_val_t) claimed)) {
+                return idx;
+            }
+
+            used = atomic_get(&bitmap[word]);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Give a slot back to its bitmap
+ *
+ * @param bitmap[in,out] Bitmap defined with ATOMIC_DEFINE
+ * @param idx Index of the slot
+ */
+static inline void rart_bitmap_release(atomic_t *bitmap, size_t idx) {
+    atomic_clear_bit(bitmap, idx);
+}
+
+/**
+ * @brief Get an object of a pool by its index
+ *
+ * @param pool[in] Pool
+ * @param idx Index of the object
+ * @return void* Address of the object.
+ */
+static inline void *rart_pool_at(const struct rart_pool *pool, size_t idx) {
+    return (uint8_t *) pool->objects + idx * pool->object_size;
+}
+
+/**
+ * @brief Get the index of an object of a pool by its address
+ *
+ * @param pool[in] Pool
+ * @param obj[in] Address of the object
+ * @return int Index of the object, -1 if it does not belong to the pool storage.
+ */
+static inline int rart_pool_index(const struct rart_pool *pool, const void *obj) {
+    uintptr_t offset = (uintptr_t) obj - (uintptr_t) pool->objects;
+
+    if ((uintptr_t) obj < (uintptr_t) pool->objects
+        || offset >= pool->size * pool->object_size || offset % pool->object_size != 0) {
+        return -1;
+    }
+
+    return offset / pool->object_size;
+}
+
+/**
+ * @brief Take an object from a pool, or from the overflow allocator when the pool is
+ * exhausted. Objects of the pool keep the content they had when released, objects of
+ * the allocator are prepared by it.
+ *
+ * @param pool[in,out] Pool
+ * @return void* Address of the object, NULL if none is available.
+ */
+static inline void *rart_pool_get(struct rart_pool *pool) {
+    int idx = rart_bitmap_claim(pool->used, pool->size);
+
+    if (idx < 0) {
+        atomic_inc(&pool->exhausted);
+        if (pool->overflow_alloc == NULL) {
+            return NULL;
+        }
+
+        struct rart_pool_node *node =
+                pool->overflow_alloc(sizeof(struct rart_pool_node) + pool->object_size);
+        if (node == NULL) {
+            return NULL;
+        }
+
+        node->id = pool->size + (uint32_t) atomic_inc(&pool->overflowed);
+
+        k_spinlock_key_t key = k_spin_lock(&pool->overflow_lock);
+        sys_slist_append(&pool->overflow_list, &node->node);
+        k_spin_unlock(&pool->overflow_lock, key);
+
+        return node->object;
+    }
+
+    atomic_val_t in_use = atomic_inc(&pool->in_use) + 1;
+    atomic_val_t peak   = atomic_get(&pool->peak);
+
+    while (in_use > peak && !atomic_cas(&pool->peak, peak, in_use)) {
+        peak = atomic_get(&pool->peak);
+    }
+
+    return rart_pool_at(pool, idx);
+}
+
+/**
+ * @brief Give an object back to its pool, or to the overflow allocator. An object of the
+ * pool given back twice is ignored the second time.
+ *
+ * @param pool[in,out] Pool
+ * @param obj[in] Object taken with rart_pool_get
+ */
+static inline void rart_pool_put(struct rart_pool *pool, void *obj) {
+    int idx = rart_pool_index(pool, obj);
+
+    if (idx < 0) {
+        if (pool->overflow_free == NULL) {
+            return;
+        }
+
+        /* Foreign pointers, and objects given back twice, are not in the list */
+        struct rart_pool_node *node = CONTAINER_OF(obj, struct rart_pool_node, object);
+        k_spinlock_key_t key        = k_spin_lock(&pool->overflow_lock);
+        bool found = sys_slist_find_and_remove(&pool->overflow_list, &node->node);
+        k_spin_unlock(&pool->overflow_lock, key);
+
+        if (found) {
+            pool->overflow_free(node);
+        }
+        return;
+    }
+
+    if (!atomic_test_bit(pool->used, idx)) {
+        return;
+    }
+
+    /* Before the release, so a handle made by the next owner has the new generation */
+    if (pool->generation != NULL) {
+        pool->generation[idx]++;
+    }
+
+    /* Only the put that releases the object counts it, when two race on it */
+    if (atomic_test_and_clear_bit(pool->used, idx)) {
+        atomic_dec(&pool->in_use);
+    }
+}
+
+/**
+ * @brief Check if an address is an object of a pool, in its storage or from its
+ * overflow allocator and in use. Objects of the allocator are searched in a list, so
+ * the check is slower for them.
+ *
+ * @param pool[in] Pool
+ * @param obj[in] Address
+ * @return bool True if the address is an object of the pool.
+ */
+static inline bool rart_pool_contains(struct rart_pool *pool, const void *obj) {
+    if (rart_pool_index(pool, obj) >= 0) {
+        return true;
+    }
+
+    if (pool->overflow_alloc == NULL) {
+        return false;
+    }
+
+    /* Only compared, a foreign pointer is never dereferenced */
+    const sys_snode_t *link = &CONTAINER_OF(obj, struct rart_pool_node, object)->node;
+    bool found              = false;
+    sys_snode_t *node;
+
+    k_spinlock_key_t key = k_spin_lock(&pool->overflow_lock);
+    SYS_SLIST_FOR_EACH_NODE(&pool->overflow_list, node) {
+        if (node == link) {
+            found = true;
+            break;
+        }
+    }
+    k_spin_unlock(&pool->overflow_lock, key);
+
+    return found;
+}
+
+/**
+ * @brief Get the identifier of an object of a pool: its index in the storage, or the
+ * pool size plus its allocation number for an object of the overflow allocator
+ *
+ * @param pool[in] Pool
+ * @param obj[in] Object of the pool, see rart_pool_contains
+ * @return uint32_t Identifier of the object.
+ */
+static inline uint32_t rart_pool_id(const struct rart_pool *pool, const void *obj) {
+    int idx = rart_pool_index(pool, obj);
+
+    if (idx >= 0) {
+        return idx;
+    }
+
+    return CONTAINER_OF(obj, struct rart_pool_node, object)->id;
+}
+
+/**
+ * @brief Check if an object of a pool is in use
+ *
+ * @param pool[in] Pool
+ * @param idx Index of the object
+ * @return bool True if the object is in use.
+ */
+static inline bool rart_pool_is_used(const struct rart_pool *pool, size_t idx) {
+    return idx < pool->size && atomic_test_bit(pool->used, idx);
+}
+
+/**
+ * @brief Release every object of a pool at once, the objects of the overflow allocator
+ * back to it. No object may still be used. The peak restarts from zero, the exhausted
+ * and overflowed counters keep counting since boot.
+ *
+ * @param pool[in,out] Pool
+ */
+static inline void rart_pool_reset(struct rart_pool *pool) {
+    /* Handles made before the reset become stale, as if each object had been put */
+    if (pool->generation != NULL) {
+        for (size_t idx = 0; idx < pool->size; ++idx) {
+            if (atomic_test_bit(pool->used, idx)) {
+                pool->generation[idx]++;
+            }
+        }
+    }
+
+    for (size_t word = 0; word < ATOMIC_BITMAP_SIZE(pool->size); ++word) {
+        atomic_set(&pool->used[word], 0);
+    }
+    atomic_set(&pool->in_use, 0);
+    atomic_set(&pool->peak, 0);
+
+    if (pool->overflow_free == NULL) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&pool->overflow_lock);
+    sys_slist_t overflow = pool->overflow_list;
+
+    sys_slist_init(&pool->overflow_list);
+    k_spin_unlock(&pool->overflow_lock, key);
+
+    sys_snode_t *node;
+    while ((node = sys_slist_get(&overflow)) != NULL) {
+        pool->overflow_free(CONTAINER_OF(node, struct rart_pool_node, node));
+    }
+}
+
+/**
+ * @brief Make a handle for an object of a pool. With RART_POOL_GENERATIONS, the handle
+ * also carries the generation of the object.
+ *
+ * @param pool[in] Pool
+ * @param idx Index of the object
+ * @return int32_t Handle, never negative.
+ */
+static inline int32_t rart_pool_handle(const struct rart_pool *pool, size_t idx) {
+    uint32_t generation = (pool->generation != NULL) ? pool->generation[idx] : 0;
+
+    return (int32_t) ((generation << 16) | idx);
+}
+
+/**
+ * @brief Get the index of the object of a handle
+ *
+ * @param pool[in] Pool
+ * @param handle Handle made with rart_pool_handle
+ * @return int Index of the object, -1 if the handle is invalid or stale.
+ */
+static inline int rart_pool_handle_index(const struct rart_pool *pool, uint32_t handle) {
+    size_t idx = handle & 0xFFFF;
+
+    if (!rart_pool_is_used(pool, idx) || (int32_t) handle != rart_pool_handle(pool, idx)) {
+        return -1;
+    }
+
+    return idx;
+}
+
+/**
+ * @brief Get the usage statistics of a pool
+ *
+ * @param pool[in] Pool
+ * @param stats[out] Usage statistics
+ */
+static inline void rart_pool_stats_get(const struct rart_pool *pool, rart_pool_stats_t *stats) {
+    stats->size       = pool->size;
+    stats->in_use     = atomic_get(&pool->in_use);
+    stats->peak       = atomic_get(&pool->peak);
+    stats->exhausted  = atomic_get(&pool->exhausted);
+    stats->overflowed = atomic_get(&pool->overflowed);
+}
+
+#endif /* RART_POOL_H */
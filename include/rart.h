@@ -0,0 +1,433 @@
+/**
+ * @file rart.h
+ * @brief Definitions shared by the RART backends
+ * @version 0.1
+ */
+
+#ifndef RART_H
+#define RART_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Type of the user timer callback called when a timer expires.
+ *
+ * @param state State of user timer callback. This state is required by RART-rs
+ */
+typedef void (*rart_timer_callback_t)(const void *state);
+
+/**
+ * @brief Backend ABI used by RART-rs. Every backend implements all of these functions,
+ * and includes this header so the compiler checks its definitions against them.
+ *
+ * Common rules for every backend:
+ * - A timeout of 0 never blocks; other timeouts are in milliseconds.
+ * - A lock, send or receive that cannot complete returns -EBUSY (mutex) or -ENOMSG
+ *   (message queue) with a timeout of 0, and -EAGAIN when the timeout expires.
+ * - Mutexes are recursive: the task holding a mutex can lock it again, and releases it
+ *   with the same number of unlocks.
+ * - Message queues deliver the items in FIFO order.
+ * - An exhausted mutex or message queue pool returns NULL.
+ *
+ * The conformance suite in tests checks these rules on a backend.
+ */
+
+/**
+ * @brief Print a formatted string as an error
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void print_error(const char *format, ...);
+
+/**
+ * @brief Print a formatted string as a log message
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void log_fn(const char *format, ...);
+
+/**
+ * @brief Print the filename and line as a debug message
+ *
+ * @param file[in] The filename
+ * @param line The line
+ */
+void trace_fn(const char *file, uint32_t line);
+
+/**
+ * @brief Get the time since the system start, in seconds
+ *
+ * @return uint32_t Current timestamp
+ */
+uint32_t timestamp(void);
+
+/**
+ * @brief Get the time since the system start, in milliseconds
+ *
+ * @return uint32_t Current timestamp, in milliseconds
+ */
+uint32_t timestamp_millis(void);
+
+/**
+ * @brief Print a formatted string and stop the system. It never returns.
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void panic(const char *format, ...);
+
+/**
+ * @brief Get a free mutex from the pool
+ *
+ * @return void* Mutex reference, NULL if the pool is exhausted.
+ */
+void *rtos_mutex_new(void);
+
+/**
+ * @brief Give a mutex back to the pool
+ *
+ * @param mutex[in] Mutex reference
+ */
+void rtos_mutex_del(void *mutex);
+
+/**
+ * @brief Lock a mutex
+ *
+ * @param mutex[in] Mutex reference
+ * @param timeout Timeout of the operation, in milliseconds
+ * @return int32_t 0 if success, -EBUSY or -EAGAIN if the mutex was not acquired.
+ */
+int32_t rtos_mutex_lock(void *mutex, uint32_t timeout);
+
+/**
+ * @brief Unlock a mutex
+ *
+ * @param mutex[in] Mutex reference
+ * @return int32_t 0 if success, -EPERM if the caller does not hold the mutex.
+ */
+int32_t rtos_mutex_unlock(void *mutex);
+
+/**
+ * @brief Get a message queue from the pool. The queues are created once, when the tasks
+ * start: each one is handed out once and never given back, since its owner may still use
+ * it or have tasks blocked on it, so the ABI has no call to delete a queue. Once the pool
+ * is exhausted, NUM_OF_MSGQ queues or, on Zephyr, MSGQ_POOL_SIZE bytes of storage, every
+ * later call returns NULL for the life of the image. The pool of the manifest must cover
+ * every queue of the application. Before, the pool wrapped around and re-initialized the
+ * queues in use.
+ *
+ * @param data_size Item size of the message queue
+ * @return void* Message queue reference, NULL if the item size is not supported or the
+ * pool is exhausted.
+ */
+void *rtos_msgq_new(size_t data_size);
+
+/**
+ * @brief Send an item to the back of a message queue
+ *
+ * @param msgq[in] Message queue reference
+ * @param data[in] Item with the size of the queue items
+ * @param timeout Timeout of the operation, in milliseconds
+ * @return int32_t 0 if success, -ENOMSG or -EAGAIN if the queue stayed full.
+ */
+int32_t rtos_msgq_send(void *msgq, const void *data, uint32_t timeout);
+
+/**
+ * @brief Receive the item at the front of a message queue
+ *
+ * @param msgq[in] Message queue reference
+ * @param data_out[out] Address of the out item
+ * @param timeout Timeout of the operation, in milliseconds
+ * @return int32_t 0 if success, -ENOMSG or -EAGAIN if the queue stayed empty.
+ */
+int32_t rtos_msgq_recv(void *msgq, void *data_out, uint32_t timeout);
+
+/**
+ * @brief Initialize the timer pool. Called once before any other timer function.
+ */
+void rtos_timer_init(void);
+
+/**
+ * @brief Call a callback once after a timeout, using a free timer of the pool
+ *
+ * @param callback[in] User callback called when the timer expires
+ * @param state[in] Context passed to user callback
+ * @param timeout Time to expire, in milliseconds
+ */
+void rtos_timer_reschedule(rart_timer_callback_t callback, const void *state,
+                           uint32_t timeout);
+
+/**
+ * @brief What a periodic timer does with the periods that passed while it was late
+ */
+typedef enum {
+    RART_TIMER_MISSED_BURST, /**< Call the callback once per missed period, back to back */
+    RART_TIMER_MISSED_SKIP,  /**< Drop the missed periods and keep the original phase */
+    RART_TIMER_MISSED_DELAY, /**< Drop the missed periods and restart the period from now */
+} rart_timer_missed_policy_t;
+
+/**
+ * @brief Call a callback every period, using a timer of the pool until it is stopped.
+ * The deadlines are absolute, start + n * period, so a late callback does not delay
+ * the next ones.
+ *
+ * @param callback[in] User callback called on each period
+ * @param state[in] Context passed to user callback
+ * @param period Period, in milliseconds, not zero
+ * @param policy What to do with the periods missed while the timer was late
+ * @return void* Periodic timer reference, NULL if there is no free timer.
+ */
+void *rtos_timer_periodic_start(rart_timer_callback_t callback, const void *state,
+                                uint32_t period, rart_timer_missed_policy_t policy);
+
+/**
+ * @brief Stop a periodic timer and give it back to the pool
+ *
+ * @param timer[in] Periodic timer reference
+ */
+void rtos_timer_periodic_stop(void *timer);
+
+/**
+ * @brief Get the number of periods a periodic timer expired late. With
+ * RART_TIMER_MISSED_BURST they were called late, otherwise they were dropped.
+ *
+ * @param timer[in] Periodic timer reference
+ * @return uint32_t Number of late periods.
+ */
+uint32_t rtos_timer_periodic_missed(void *timer);
+
+/**
+ * @brief Alloc a memory chunk in the RART heap. It never returns NULL.
+ *
+ * @param align Align of the memory chunk, a power of two
+ * @param bytes Number of bytes of the memory chunk
+ * @return void* Memory Address
+ */
+const void *heap_alloc(size_t align, size_t bytes);
+
+/**
+ * @brief Dealloc a memory chunk of the RART heap
+ *
+ * @param mem Memory address
+ */
+void heap_free(const void *mem);
+
+/**
+ * @brief Log levels. A message is emitted only if its level is lower or equal to the
+ * configured one.
+ */
+#define RART_LOG_LEVEL_NONE 0
+#define RART_LOG_LEVEL_ERR  1
+#define RART_LOG_LEVEL_WRN  2
+#define RART_LOG_LEVEL_INF  3
+#define RART_LOG_LEVEL_DBG  4
+
+/**
+ * @brief Compile-time log level. Calls above this level are removed by the compiler,
+ * arguments included.
+ */
+#ifndef CONFIG_RART_LOG_LEVEL
+#define CONFIG_RART_LOG_LEVEL RART_LOG_LEVEL_DBG
+#endif
+
+/**
+ * @brief Modules with an independent runtime log level
+ */
+typedef enum {
+    RART_LOG_MODULE_RUST,  /**< Messages sent by RART-rs through log_fn and trace_fn */
+    RART_LOG_MODULE_MUTEX, /**< Mutex pool */
+    RART_LOG_MODULE_MSGQ,  /**< Message queue pool */
+    RART_LOG_MODULE_TIMER, /**< Timer pool */
+    RART_LOG_MODULE_HEAP,  /**< Heap allocator */
+    RART_LOG_MODULE_ZBUS,  /**< ZBUS backend */
+    RART_LOG_MODULE_COUNT, /**< Number of modules */
+} rart_log_module_t;
+
+/**
+ * @brief Check if a message of a level must be emitted by a module. The first operand
+ * is a constant, so disabled levels are eliminated at compile time.
+ */
+#define RART_LOG_ENABLED(module, level)                                                  \
+    (((level) <= CONFIG_RART_LOG_LEVEL) && ((level) <= rtos_log_level_get(module)))
+
+#define RART_LOG(module, level, ...)                                                     \
+    do {                                                                                 \
+        if (RART_LOG_ENABLED(module, level)) {                                           \
+            rart_log_print(level, __VA_ARGS__);                                          \
+        }                                                                                \
+    } while (0)
+
+#define RART_LOG_ERR(module, ...) RART_LOG(module, RART_LOG_LEVEL_ERR, __VA_ARGS__)
+#define RART_LOG_WRN(module, ...) RART_LOG(module, RART_LOG_LEVEL_WRN, __VA_ARGS__)
+#define RART_LOG_INF(module, ...) RART_LOG(module, RART_LOG_LEVEL_INF, __VA_ARGS__)
+#define RART_LOG_DBG(module, ...) RART_LOG(module, RART_LOG_LEVEL_DBG, __VA_ARGS__)
+
+/**
+ * @brief Print a formatted string prefixed by the level tag. Use the RART_LOG_* macros
+ * instead of calling it directly.
+ *
+ * @param level Level of the message
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void rart_log_print(uint8_t level, const char *format, ...);
+
+/**
+ * @brief Set the runtime log level of a module. Levels above CONFIG_RART_LOG_LEVEL
+ * remain disabled.
+ *
+ * @param module Module to be configured
+ * @param level New log level
+ */
+void rtos_log_level_set(uint32_t module, uint8_t level);
+
+/**
+ * @brief Get the runtime log level of a module
+ *
+ * @param module Module
+ * @return uint8_t Log level of the module, RART_LOG_LEVEL_NONE if the module is invalid.
+ */
+uint8_t rtos_log_level_get(uint32_t module);
+
+/**
+ * @brief Executor scheduling events reported by the trace hooks. Timer and mutex indices
+ * at or above the pool size are objects taken from the heap.
+ */
+typedef enum {
+    RART_TRACE_POLL_START,      /**< Task poll started. arg0: task id */
+    RART_TRACE_POLL_END,        /**< Task poll finished. arg0: task id */
+    RART_TRACE_WAKE_TIMER,      /**< Timer expired. arg0: timer index, arg1: state */
+    RART_TRACE_WAKE_MSGQ,       /**< Item sent. arg0: queue index, arg1: items used */
+    RART_TRACE_WAKE_ZBUS,       /**< Observer notified. arg0: channel, arg1: state */
+    RART_TRACE_MUTEX_CONTENDED, /**< Mutex busy on lock. arg0: mutex index, arg1: owner */
+    RART_TRACE_EVENT_COUNT,     /**< Number of events */
+} rart_trace_event_t;
+
+#if defined(CONFIG_RART_TRACING)
+/**
+ * @brief Emit a scheduling event to the tracing backend
+ *
+ * @param event Event identifier
+ * @param arg0 First event argument
+ * @param arg1 Second event argument
+ */
+void rart_trace_event(rart_trace_event_t event, uint32_t arg0, uint32_t arg1);
+
+#define RART_TRACE(event, arg0, arg1)                                                    \
+    rart_trace_event(event, (uint32_t) (uintptr_t) (arg0), (uint32_t) (uintptr_t) (arg1))
+#else
+#define RART_TRACE(event, arg0, arg1)                                                    \
+    do {                                                                                 \
+        if (0) {                                                                         \
+            (void) (arg0);                                                               \
+            (void) (arg1);                                                               \
+        }                                                                                \
+    } while (0)
+#endif
+
+/**
+ * @brief Mark the start of a task poll. Called by the RART-rs executor.
+ *
+ * @param task Task identifier
+ */
+void rtos_trace_poll_start(uint32_t task);
+
+/**
+ * @brief Mark the end of a task poll. Called by the RART-rs executor.
+ *
+ * @param task Task identifier
+ */
+void rtos_trace_poll_end(uint32_t task);
+
+/**
+ * @brief Contention statistics of a mutex pool slot
+ */
+typedef struct {
+    uint32_t acquisitions;  /**< Number of successful locks */
+    uint32_t contended;     /**< Number of locks that found the mutex busy */
+    uint64_t wait_total_us; /**< Total time waiting for the mutex, in microseconds */
+    uint32_t wait_max_us;   /**< Longest wait for the mutex, in microseconds */
+    uint64_t hold_total_us; /**< Total time holding the mutex, in microseconds */
+    uint32_t hold_max_us;   /**< Longest hold of the mutex, in microseconds */
+    void *owner;            /**< Task holding the mutex, NULL if it is unlocked */
+} rart_mutex_stats_t;
+
+/**
+ * @brief Get the contention statistics of a mutex pool slot. Requires
+ * CONFIG_RART_MUTEX_PROFILING.
+ *
+ * @param idx Index of the mutex in the pool
+ * @param stats[out] Statistics of the mutex
+ * @return int32_t 0 if success, -EINVAL if the index is out of the pool,
+ * -ENOTSUP if the profiling is disabled.
+ */
+int32_t rtos_mutex_stats_get(uint32_t idx, rart_mutex_stats_t *stats);
+
+/**
+ * @brief Clear the contention statistics of all mutexes
+ */
+void rtos_mutex_stats_reset(void);
+
+/**
+ * @brief Occupancy and latency statistics of a message queue
+ */
+typedef struct {
+    uint32_t sent;              /**< Number of items sent */
+    uint32_t received;          /**< Number of items received */
+    uint32_t peak_used;         /**< Highest number of items stored at once */
+    uint32_t full;              /**< Number of sends that found the queue full */
+    uint32_t empty;             /**< Number of receives that found the queue empty */
+    uint64_t blocked_total_us;  /**< Total time blocked on a full or empty queue */
+    uint64_t latency_total_us;  /**< Total enqueue-to-dequeue latency of the items */
+    uint32_t latency_max_us;    /**< Highest enqueue-to-dequeue latency of an item */
+} rart_msgq_stats_t;
+
+/**
+ * @brief Get the statistics of a message queue. Requires CONFIG_RART_MSGQ_STATS.
+ *
+ * @param idx Index of the message queue in the pool
+ * @param stats[out] Statistics of the message queue
+ * @return int32_t 0 if success, -EINVAL if the index is out of the pool,
+ * -ENOTSUP if the statistics are disabled.
+ */
+int32_t rtos_msgq_stats_get(uint32_t idx, rart_msgq_stats_t *stats);
+
+/**
+ * @brief Clear the statistics of all message queues
+ */
+void rtos_msgq_stats_reset(void);
+
+/**
+ * @brief Object pools of the backend
+ */
+typedef enum {
+    RART_POOL_MUTEX, /**< Mutex pool */
+    RART_POOL_TIMER, /**< Timer pool */
+    RART_POOL_COUNT, /**< Number of pools */
+} rart_pool_id_t;
+
+/**
+ * @brief Usage statistics of an object pool
+ */
+typedef struct {
+    uint32_t size;       /**< Number of objects of the pool */
+    uint32_t in_use;     /**< Objects of the pool in use */
+    uint32_t peak;       /**< Highest number of objects of the pool in use */
+    uint32_t exhausted;  /**< Allocations that found the pool exhausted */
+    uint32_t overflowed; /**< Allocations served by the overflow allocator */
+} rart_pool_stats_t;
+
+/**
+ * @brief Get the usage statistics of an object pool
+ *
+ * @param pool Pool
+ * @param stats[out] Usage statistics of the pool
+ * @return int32_t 0 if success, -EINVAL if the pool is unknown,
+ * -ENOTSUP if the backend has no object pools.
+ */
+int32_t rtos_pool_stats_get(rart_pool_id_t pool, rart_pool_stats_t *stats);
+
+#endif /* RART_H */
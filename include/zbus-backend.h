@@ -0,0 +1,213 @@
+/**
+ * @file zbus-backend.h
+ * @brief ABI of the RART backend for the ZBUS library
+ * @version 0.1
+ */
+
+#ifndef ZBUS_BACKEND_H
+#define ZBUS_BACKEND_H
+
+#include <stdint.h>
+
+/**
+ * @brief Type of user read callback called inside default zbus read callback.
+ *
+ * @param state State of the user read callback. This state is required by RART-rs.
+ * @param data Data got by ZBUS read operation.
+ * @param data_len Data length of ZBUS data read.
+ */
+typedef void (*zbus_backend_callback_t)(void *state, void *data, uint32_t data_len);
+
+/**
+ * @brief Type of the callback that ends the wait of an asynchronous publication
+ *
+ * @param state State of the callback. This state is required by RART-rs.
+ * @param result 0 if the channel became available, -EAGAIN if the timeout expired.
+ */
+typedef void (*zbus_backend_publish_callback_t)(void *state, int32_t result);
+
+/**
+ * @brief Type of the callback of a channel set observer
+ *
+ * @param state State of the callback. This state is required by RART-rs.
+ * @param changed Mask of the observed channels that changed, bit N is the channel N
+ */
+typedef void (*zbus_backend_set_callback_t)(void *state, uint32_t changed);
+
+/**
+ * @brief Message of a batch publication
+ */
+typedef struct {
+    uint32_t id;      /**< Channel index */
+    const void *data; /**< Message */
+    uint32_t size;    /**< Message size, equal to the channel message size */
+} zbus_backend_batch_item_t;
+
+/**
+ * @brief Maximum number of items of rtos_zbus_publish_batch
+ */
+#define RTOS_ZBUS_BATCH_MAX 32
+
+/**
+ * @brief Publication counters of a channel
+ */
+typedef struct {
+    uint32_t failures; /**< Publications that failed, usually on a busy channel */
+    uint32_t waits;    /**< Asynchronous publications that waited for the channel */
+    uint32_t timeouts; /**< Waits that expired before the channel became available */
+    uint32_t missed;   /**< Dispatches that could not read the message of the channel */
+} zbus_backend_publish_stats_t;
+
+/**
+ * @brief Timeout of rtos_zbus_publish_async that never expires
+ */
+#define RTOS_ZBUS_WAIT_FOREVER UINT32_MAX
+
+/**
+ * @brief Register a one-shot observer of a channel. The callback is called on the next
+ * message published on the channel and the observer is released.
+ *
+ * @param id Channel index
+ * @param state[in] Context passed to the callback
+ * @param callback[in] Callback called with the message
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid, -ENOMEM if the
+ * observer pool is exhausted.
+ */
+int32_t rtos_zbus_register_observer(uint32_t id, const void *state,
+                                    zbus_backend_callback_t callback);
+
+/**
+ * @brief Publish a message in a channel without waiting
+ *
+ * @param id Channel index
+ * @param data[in] Message
+ * @param size Message size
+ * @return int32_t 0 if success, errno otherwise.
+ */
+int32_t rtos_zbus_publish(uint32_t id, const void *data, uint32_t size);
+
+/**
+ * @brief Publish a message in a channel. If the channel is busy, the callback is
+ * registered and called when the channel becomes available, so the publisher can try
+ * again instead of spinning. A release through the backend wakes the publisher at once,
+ * other releases are seen within CONFIG_RART_ZBUS_WAIT_POLL_MS.
+ *
+ * @param id Channel index
+ * @param data[in] Message
+ * @param size Message size
+ * @param state[in] Context passed to the callback
+ * @param callback[in] Callback called with 0 when the channel becomes available, or with
+ * -EAGAIN when the timeout expires
+ * @param timeout Maximum wait in milliseconds, 0 to not wait or RTOS_ZBUS_WAIT_FOREVER
+ * @return int32_t 0 if published, -EINPROGRESS if the callback will be called, errno
+ * otherwise.
+ */
+int32_t rtos_zbus_publish_async(uint32_t id, const void *data, uint32_t size, const void *state,
+                                zbus_backend_publish_callback_t callback, uint32_t timeout);
+
+/**
+ * @brief Get the publication counters of a channel
+ *
+ * @param id Channel index
+ * @param stats[out] Counters of the channel
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid.
+ */
+int32_t rtos_zbus_publish_stats_get(uint32_t id, zbus_backend_publish_stats_t *stats);
+
+/**
+ * @brief Register a one-shot observer of a set of channels. Only the first 32 channels
+ * can be observed in a set.
+ *
+ * @param mask Channels observed, bit N is the channel N
+ * @param state[in] Context passed to the callback
+ * @param callback[in] Callback called once with the changed channels
+ * @return int32_t 0 if success, -EINVAL if the mask is invalid, -ENOMEM if there is no
+ * free set observer.
+ */
+int32_t rtos_zbus_register_set_observer(uint32_t mask, const void *state,
+                                        zbus_backend_set_callback_t callback);
+
+/**
+ * @brief Update several channels and run a single dispatch pass over their observers.
+ * Each message is published with zbus_chan_pub, so the ZBUS listeners and subscribers of
+ * the application see it as usual. The RART observers run after every message is
+ * published, and each set observer is called once with all the changed channels.
+ *
+ * @param items[in] Channels and messages to publish, each channel at most once
+ * @param count Number of items, up to RTOS_ZBUS_BATCH_MAX
+ * @return int32_t 0 if success, -EINVAL if an item is invalid or a channel repeats, errno
+ * of the first channel that could not be published otherwise.
+ */
+int32_t rtos_zbus_publish_batch(const zbus_backend_batch_item_t *items, uint32_t count);
+
+/**
+ * @brief Dispatch the last message of a channel to its observers. Called by the ZBUS
+ * listener of the application for each publication.
+ *
+ * @param idx Channel index
+ */
+void rtos_zbus_default_listener_callback(uint32_t idx);
+
+/**
+ * @brief Borrow the message of a channel without copying it. The channel stays claimed,
+ * and publications on it fail, until rtos_zbus_finish is called.
+ *
+ * @param id Channel index
+ * @param msg[out] Address of the channel message
+ * @param size[out] Size of the channel message
+ * @param timeout Timeout to claim the channel, in milliseconds
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid, errno otherwise.
+ */
+int32_t rtos_zbus_borrow(uint32_t id, const void **msg, uint32_t *size, uint32_t timeout);
+
+/**
+ * @brief Release a channel borrowed with rtos_zbus_borrow
+ *
+ * @param id Channel index
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid, errno otherwise.
+ */
+int32_t rtos_zbus_finish(uint32_t id);
+
+/**
+ * @brief Subscribe to every message of a channel. The messages are queued for the
+ * subscriber and the callback is called with a NULL message each time one is queued.
+ * The subscription functions return -ENOTSUP when the backend is generated without
+ * subscribers (gen_files.py -s 0).
+ *
+ * @param id Channel index
+ * @param state[in] Context passed to the callback
+ * @param callback[in] Callback called when a message is queued
+ * @return int32_t Subscription handle if success, -EINVAL if the channel is invalid,
+ * -ENOMEM if there is no free subscriber, -ENOTSUP without subscribers.
+ */
+int32_t rtos_zbus_subscribe(uint32_t id, const void *state, zbus_backend_callback_t callback);
+
+/**
+ * @brief Cancel a subscription
+ *
+ * @param handle Subscription handle
+ * @return int32_t 0 if success, -EINVAL if the handle is invalid or was already
+ * unsubscribed, -ENOTSUP without subscribers.
+ */
+int32_t rtos_zbus_unsubscribe(uint32_t handle);
+
+/**
+ * @brief Read the oldest message queued for a subscriber, without waiting
+ *
+ * @param handle Subscription handle
+ * @param data_out[out] Address of the out message, with the channel message size
+ * @return int32_t 0 if success, -ENOMSG if there is no message, -EINVAL if the handle is
+ * invalid, -ENOTSUP without subscribers.
+ */
+int32_t rtos_zbus_subscription_recv(uint32_t handle, void *data_out);
+
+/**
+ * @brief Get the number of messages a subscriber lost because its queue was full
+ *
+ * @param handle Subscription handle
+ * @return uint32_t Number of dropped messages, 0 if the handle is invalid or without
+ * subscribers.
+ */
+uint32_t rtos_zbus_subscription_drops(uint32_t handle);
+
+#endif /* ZBUS_BACKEND_H */
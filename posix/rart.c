@@ -0,0 +1,951 @@
+/**
+ * @file rart.c
+ * @author Matheus T. dos Santos (tenoriomatheus0@gmail.com)
+ * @brief Backend of RART for POSIX hosts (Linux)
+ * @version 0.1
+ * @date 16/10/2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Runs RART as a regular Linux process: mutexes are pthread mutexes, message queues
+ * are lock-free rings that block on futexes, timers are timerfds served by an epoll
+ * thread and the heap is the C library allocator.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rart-defines.h"
+#include "rart.h"
+
+/*
+ * Pool sizes. Each one can be set by the resource manifest of gen_files.py in
+ * rart-defines.h, otherwise it is derived from the number of tasks.
+ */
+
+/**
+ * @brief Number of the mutexes
+ */
+#ifndef NUM_OF_MUTEXES
+#define NUM_OF_MUTEXES (7 * NUM_OF_TASKS)
+#endif
+
+/**
+ * @brief Number of the message queues
+ */
+#ifndef NUM_OF_MSGQ
+#define NUM_OF_MSGQ (4 * NUM_OF_TASKS)
+#endif
+
+/**
+ * @brief Depth of each message queue. It does not grow with the number of tasks, so the
+ * queue storage stays linear in the number of queues.
+ */
+#ifndef NUM_OF_MSG_ITENS
+#define NUM_OF_MSG_ITENS 8
+#endif
+
+/**
+ * @brief Maximum size of the message queue item
+ */
+#ifndef MSG_ITEM_SIZE
+#define MSG_ITEM_SIZE 8
+#endif
+
+/**
+ * @brief Number of the timers
+ */
+#ifndef NUM_OF_TIMERS
+#define NUM_OF_TIMERS NUM_OF_TASKS
+#endif
+
+/**
+ * @brief Invalid index
+ */
+#define INVALID_INDEX ((rart_index_t) -1)
+
+/**
+ * @brief Nanoseconds in a millisecond
+ */
+#define NSEC_PER_MSEC 1000000ULL
+
+/**
+ * @brief Type of the index used in this lib. It is as narrow as the largest pool
+ * allows, the all-ones value being reserved for INVALID_INDEX.
+ */
+#if NUM_OF_MUTEXES > 254 || NUM_OF_MSGQ > 254 || NUM_OF_TIMERS > 254
+typedef uint16_t rart_index_t;
+#else
+typedef uint8_t rart_index_t;
+#endif
+
+_Static_assert(NUM_OF_MUTEXES < UINT16_MAX && NUM_OF_MSGQ < UINT16_MAX
+                       && NUM_OF_TIMERS < UINT16_MAX,
+               "Pools are limited to 65534 objects");
+
+/**
+ * @brief Bounded multi-producer multi-consumer ring. Each cell has a sequence number
+ * that tells if it is ready to be written (seq == pos) or read (seq == pos + 1).
+ */
+struct rart_msgq {
+    uint8_t buffer[NUM_OF_MSG_ITENS * MSG_ITEM_SIZE]; /**< Message queue storage */
+    atomic_size_t seq[NUM_OF_MSG_ITENS];              /**< Sequence of each cell */
+    atomic_size_t enqueue_pos;                        /**< Next position to write */
+    atomic_size_t dequeue_pos;                        /**< Next position to read */
+    atomic_uint not_empty;  /**< Futex word, incremented on each send */
+    atomic_uint not_full;   /**< Futex word, incremented on each receive */
+    atomic_uint waiters;    /**< Number of threads blocked on the futex words */
+    size_t item_size;       /**< Item size of the queue */
+};
+
+/**
+ * @brief Struct with global variables of the RART-c
+ */
+static struct rart_fields {
+    struct {
+        pthread_mutex_t mutex; /**< POSIX mutex. */
+        atomic_bool is_free;   /**< Flag to check if the mutex is free */
+        bool is_init;          /**< Flag to check the mutex initialization. */
+    } mutexes[NUM_OF_MUTEXES]; /**< List of mutexes */
+    struct {
+        struct rart_msgq instance[NUM_OF_MSGQ]; /**< List of Message Queues */
+        atomic_uint index; /**< Number of message queues handed out */
+    } msgq;                /**< Message queue sub-struct */
+    struct {
+        const void
+                *state; /**< Reference to state that will be sent in the timer callback. */
+        rart_timer_callback_t callback; /**< Timer callback */
+        int fd;                         /**< timerfd of the timer */
+        uint32_t period;                /**< Period in milliseconds, 0 if one-shot */
+        uint32_t missed;                /**< Periods of a periodic timer expired late */
+        rart_timer_missed_policy_t policy; /**< Missed-tick policy of a periodic timer */
+        atomic_bool is_free;            /**< Flag to check if the timer is free */
+        atomic_uint epoch;              /**< Incremented each time the timer is stopped */
+    } timers[NUM_OF_TIMERS];            /**< List of timers */
+    pthread_mutex_t timer_lock;         /**< Serializes a stop with the re-arm of a timer */
+    int epoll_fd;                       /**< epoll instance watching the timerfds */
+    pthread_t timer_thread;             /**< Thread that runs the timer callbacks */
+    bool timers_init;                   /**< Flag to check the timers initialization */
+} self = {
+        .mutexes = {[0 ...(NUM_OF_MUTEXES - 1)] =
+                {
+                        .is_free = true,
+                        .is_init = false,
+                }},
+        .timers = {[0 ...(NUM_OF_TIMERS - 1)] =
+                {
+                        .state    = NULL,
+                        .callback = NULL,
+                        .fd       = -1,
+                        .is_free  = true,
+                }},
+        .timer_lock  = PTHREAD_MUTEX_INITIALIZER,
+        .epoll_fd    = -1,
+        .timers_init = false,
+};
+
+/**
+ * @brief Runtime log level of each module
+ */
+static uint8_t log_levels[RART_LOG_MODULE_COUNT] = {
+        [0 ...(RART_LOG_MODULE_COUNT - 1)] = CONFIG_RART_LOG_LEVEL};
+
+/**
+ * @brief Search the next timer free
+ *
+ * @return rart_index_t Index of the next free timer
+ */
+static rart_index_t search_free_timer();
+
+/**
+ * @brief Search the next free mutex
+ *
+ * @return rart_index_t Index of the next free mutex
+ */
+static rart_index_t search_free_mutex();
+
+/**
+ * @brief Search the mutex by its address
+ *
+ * @param mutex[in] Mutex address
+ * @return rart_index_t Index of the mutex.
+ */
+static rart_index_t search_mutex(pthread_mutex_t *mutex);
+
+/**
+ * @brief Write an item in the ring without blocking
+ *
+ * @param msgq[in] Message queue
+ * @param data[in] Item to be written
+ * @return bool True if the item was written, false if the ring is full.
+ */
+static bool ring_put(struct rart_msgq *msgq, const void *data);
+
+/**
+ * @brief Read an item from the ring without blocking
+ *
+ * @param msgq[in] Message queue
+ * @param data_out[out] Address of the out item
+ * @return bool True if an item was read, false if the ring is empty.
+ */
+static bool ring_get(struct rart_msgq *msgq, void *data_out);
+
+/**
+ * @brief Block on a futex word until it changes or the deadline expires
+ *
+ * @param msgq[in] Message queue of the futex word
+ * @param word[in] Futex word
+ * @param expected Value of the word read before the failed operation
+ * @param deadline Deadline, in CLOCK_MONOTONIC nanoseconds
+ * @return bool False if the deadline already expired, true otherwise.
+ */
+static bool msgq_wait(struct rart_msgq *msgq, atomic_uint *word, unsigned expected,
+                      uint64_t deadline);
+
+/**
+ * @brief Increment a futex word and wake the threads blocked on it
+ *
+ * @param msgq[in] Message queue of the futex word
+ * @param word[in] Futex word
+ */
+static void msgq_notify(struct rart_msgq *msgq, atomic_uint *word);
+
+/**
+ * @brief Get the current time of CLOCK_MONOTONIC
+ *
+ * @return uint64_t Current time, in nanoseconds
+ */
+static uint64_t monotonic_ns();
+
+/**
+ * @brief Thread that waits the timerfds and calls the expired timer callbacks
+ *
+ * @param arg Unused
+ * @return void* Unused
+ */
+static void *timer_thread(void *arg);
+
+/**
+ * @brief Callback called when a timer expire
+ *
+ * @param idx Index of the expired timer
+ * @param expirations Periods elapsed since the last call, 1 for a one-shot timer
+ * @param epoch Epoch of the timer before its expirations were read
+ */
+static void default_callback(rart_index_t idx, uint64_t expirations, unsigned epoch);
+
+/**
+ * @brief Search a timer by its address
+ *
+ * @param timer[in] Timer address
+ * @return rart_index_t Index of the timer, INVALID_INDEX if it is not in the pool.
+ */
+static rart_index_t search_timer(const void *timer);
+
+/**
+ * @brief Print a formatted string prefixed by the level tag
+ *
+ * @param level Level of the message
+ * @param format Formatted string
+ * @param va Variable arguments
+ */
+static void log_vprint(uint8_t level, const char *format, va_list va);
+
+#if defined(CONFIG_RART_TRACING)
+void rart_trace_event(rart_trace_event_t event, uint32_t arg0, uint32_t arg1) {
+    fprintf(stderr, "[rart-trace] %llu %d %u %u\n", (unsigned long long) monotonic_ns(),
+            event, arg0, arg1);
+}
+#endif
+
+void rtos_trace_poll_start(uint32_t task) {
+    RART_TRACE(RART_TRACE_POLL_START, task, 0);
+}
+
+void rtos_trace_poll_end(uint32_t task) {
+    RART_TRACE(RART_TRACE_POLL_END, task, 0);
+}
+
+void rart_log_print(uint8_t level, const char *format, ...) {
+    va_list va;
+    va_start(va, format);
+    log_vprint(level, format, va);
+    va_end(va);
+}
+
+void rtos_log_level_set(uint32_t module, uint8_t level) {
+    if (module >= RART_LOG_MODULE_COUNT) {
+        return;
+    }
+
+    log_levels[module] = level;
+}
+
+uint8_t rtos_log_level_get(uint32_t module) {
+    if (module >= RART_LOG_MODULE_COUNT) {
+        return RART_LOG_LEVEL_NONE;
+    }
+
+    return log_levels[module];
+}
+
+/**
+ * @brief Print a formatted string with background red
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void print_error(const char *format, ...) {
+#if RART_LOG_LEVEL_ERR <= CONFIG_RART_LOG_LEVEL
+    if (!RART_LOG_ENABLED(RART_LOG_MODULE_RUST, RART_LOG_LEVEL_ERR)) {
+        return;
+    }
+
+    va_list va;
+    va_start(va, format);
+    log_vprint(RART_LOG_LEVEL_ERR, format, va);
+    va_end(va);
+#endif
+}
+
+/**
+ * @brief Print a formatted string in purple
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void log_fn(const char *format, ...) {
+#if RART_LOG_LEVEL_INF <= CONFIG_RART_LOG_LEVEL
+    if (!RART_LOG_ENABLED(RART_LOG_MODULE_RUST, RART_LOG_LEVEL_INF)) {
+        return;
+    }
+
+    va_list va;
+    va_start(va, format);
+    log_vprint(RART_LOG_LEVEL_INF, format, va);
+    va_end(va);
+#endif
+}
+
+/**
+ * @brief Print the filename and line in cyan
+ *
+ * @param file[in] The filename
+ * @param line The line
+ */
+void trace_fn(const char *file, uint32_t line) {
+    RART_LOG_DBG(RART_LOG_MODULE_RUST, "%s:%d\n", file, line);
+}
+
+/**
+ * @brief Get the current timestamp
+ *
+ * @return uint32_t Current timestamp
+ */
+uint32_t timestamp() {
+    return monotonic_ns() / (1000 * NSEC_PER_MSEC);
+}
+
+/**
+ * @brief Get the current timestamp, in milliseconds
+ *
+ * @return uint32_t Current timestamp, in milliseconds
+ */
+uint32_t timestamp_millis() {
+    return monotonic_ns() / NSEC_PER_MSEC;
+}
+
+/**
+ * @brief Print a formatted string in red and abort the process
+ *
+ * @param format Formatted string
+ * @param ... Variable arguments
+ */
+void panic(const char *format, ...) {
+    printf("[panic]");
+    va_list va;
+    va_start(va, format);
+    vprintf(format, va);
+    va_end(va);
+    fflush(stdout);
+
+    abort();
+}
+
+/**
+ * @brief Get a new POSIX mutex in the list. Like k_mutex, it can be locked again by its
+ * owner and is released by the matching number of unlocks.
+ *
+ * @return void* POSIX mutex C reference
+ */
+void *rtos_mutex_new() {
+    rart_index_t idx = search_free_mutex();
+
+    if (idx == INVALID_INDEX) {
+        RART_LOG_ERR(RART_LOG_MODULE_MUTEX, "No mutex available\n");
+        return NULL;
+    }
+
+    return &self.mutexes[idx].mutex;
+}
+
+/**
+ * @brief Free a POSIX mutex used
+ *
+ * @param mutex[in] POSIX mutex C reference
+ */
+void rtos_mutex_del(void *mutex) {
+    rart_index_t idx = search_mutex(mutex);
+
+    if (idx == INVALID_INDEX) {
+        return;
+    }
+
+    atomic_store(&self.mutexes[idx].is_free, true);
+}
+
+/**
+ * @brief Lock a POSIX mutex
+ *
+ * @param mutex[in] POSIX mutex C reference
+ * @param timeout Timeout of mutex lock operation
+ * @return int32_t 0 if success, -EBUSY if the mutex is busy and timeout is zero,
+ * -EAGAIN if the timeout expired.
+ */
+int32_t rtos_mutex_lock(void *mutex, uint32_t timeout) {
+    if (timeout == 0) {
+        return (pthread_mutex_trylock(mutex) == 0) ? 0 : -EBUSY;
+    }
+
+    /* pthread_mutex_timedlock only takes CLOCK_REALTIME deadlines */
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * NSEC_PER_MSEC;
+    if (deadline.tv_nsec >= 1000 * (long) NSEC_PER_MSEC) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000 * NSEC_PER_MSEC;
+    }
+
+    int ret = pthread_mutex_timedlock(mutex, &deadline);
+
+    return (ret == 0) ? 0 : (ret == ETIMEDOUT) ? -EAGAIN : -ret;
+}
+
+/**
+ * @brief Unlock a POSIX mutex
+ *
+ * @param mutex POSIX mutex C reference
+ * @return int32_t 0 if success, -EPERM if the caller does not hold the mutex.
+ */
+int32_t rtos_mutex_unlock(void *mutex) {
+    return -pthread_mutex_unlock(mutex);
+}
+
+int32_t rtos_mutex_stats_get(uint32_t idx, rart_mutex_stats_t *stats) {
+    (void) idx;
+    (void) stats;
+
+    return -ENOTSUP;
+}
+
+void rtos_mutex_stats_reset(void) {
+}
+
+int32_t rtos_pool_stats_get(rart_pool_id_t pool, rart_pool_stats_t *stats) {
+    (void) pool;
+    (void) stats;
+
+    return -ENOTSUP;
+}
+
+/**
+ * @brief Get a new message queue in the list. A queue is never handed out twice, since
+ * its owner may still use it or have threads blocked on it, see rart.h.
+ *
+ * @param data_size Item size of the message queue
+ * @return void* Message queue C reference, NULL if the item size is not supported or
+ * every queue was handed out.
+ */
+void *rtos_msgq_new(size_t data_size) {
+    if (data_size > MSG_ITEM_SIZE) {
+        RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "Message queue item too big\n");
+        return NULL;
+    }
+
+    unsigned idx = atomic_load(&self.msgq.index);
+
+    do {
+        if (idx >= NUM_OF_MSGQ) {
+            RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "No message queue available\n");
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak(&self.msgq.index, &idx, idx + 1));
+
+    struct rart_msgq *msgq = &self.msgq.instance[idx];
+
+    for (size_t i = 0; i < NUM_OF_MSG_ITENS; ++i) {
+        atomic_init(&msgq->seq[i], i);
+    }
+    atomic_init(&msgq->enqueue_pos, 0);
+    atomic_init(&msgq->dequeue_pos, 0);
+    msgq->item_size = data_size;
+
+    return msgq;
+}
+
+/**
+ * @brief Send the data to a message queue
+ *
+ * @param msgq[in] Message queue C reference
+ * @param data[in] Reference to the data
+ * @param timeout Timeout of the send operation
+ * @return int32_t 0 if success, -ENOMSG if the queue is full and timeout is zero,
+ * -EAGAIN if the timeout expired.
+ */
+int32_t rtos_msgq_send(void *msgq, const void *data, uint32_t timeout) {
+    struct rart_msgq *queue = msgq;
+    uint64_t deadline       = monotonic_ns() + timeout * NSEC_PER_MSEC;
+
+    for (;;) {
+        unsigned not_full = atomic_load(&queue->not_full);
+
+        if (ring_put(queue, data)) {
+            break;
+        }
+
+        if (timeout == 0) {
+            return -ENOMSG;
+        }
+
+        if (!msgq_wait(queue, &queue->not_full, not_full, deadline)) {
+            return -EAGAIN;
+        }
+    }
+
+    msgq_notify(queue, &queue->not_empty);
+    RART_TRACE(RART_TRACE_WAKE_MSGQ, queue - self.msgq.instance, 0);
+
+    return 0;
+}
+
+/**
+ * @brief Receive the data from a message queue
+ *
+ * @param msgq[in] Message queue C reference
+ * @param data_out[out] Address of the out data
+ * @param timeout Timeout of the receive operation.
+ * @return int32_t 0 if success, -ENOMSG if the queue is empty and timeout is zero,
+ * -EAGAIN if the timeout expired.
+ */
+int32_t rtos_msgq_recv(void *msgq, void *data_out, uint32_t timeout) {
+    struct rart_msgq *queue = msgq;
+    uint64_t deadline       = monotonic_ns() + timeout * NSEC_PER_MSEC;
+
+    for (;;) {
+        unsigned not_empty = atomic_load(&queue->not_empty);
+
+        if (ring_get(queue, data_out)) {
+            break;
+        }
+
+        if (timeout == 0) {
+            return -ENOMSG;
+        }
+
+        if (!msgq_wait(queue, &queue->not_empty, not_empty, deadline)) {
+            return -EAGAIN;
+        }
+    }
+
+    msgq_notify(queue, &queue->not_full);
+
+    return 0;
+}
+
+int32_t rtos_msgq_stats_get(uint32_t idx, rart_msgq_stats_t *stats) {
+    (void) idx;
+    (void) stats;
+
+    return -ENOTSUP;
+}
+
+void rtos_msgq_stats_reset(void) {
+}
+
+/**
+ * @brief Initialize all timers and start the timer thread
+ */
+void rtos_timer_init() {
+    if (self.timers_init) {
+        return;
+    }
+    self.timers_init = true;
+
+    self.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (self.epoll_fd < 0) {
+        panic("epoll_create1 failed: %s\n", strerror(errno));
+    }
+
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        atomic_store(&self.timers[i].is_free, true);
+        self.timers[i].fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (self.timers[i].fd < 0) {
+            panic("timerfd_create failed: %s\n", strerror(errno));
+        }
+
+        struct epoll_event event = {.events = EPOLLIN, .data.u32 = i};
+        epoll_ctl(self.epoll_fd, EPOLL_CTL_ADD, self.timers[i].fd, &event);
+    }
+
+    if (pthread_create(&self.timer_thread, NULL, timer_thread, NULL) != 0) {
+        panic("Timer thread creation failed\n");
+    }
+}
+
+/**
+ * @brief Schedule a free timer
+ *
+ * @param callback[in] User callback called inside the timer thread
+ * @param state[in] Context passed to user callback
+ * @param timeout Timer time to expire
+ */
+void rtos_timer_reschedule(rart_timer_callback_t callback, const void *state,
+                           uint32_t timeout) {
+    rart_index_t idx = search_free_timer();
+
+    if (idx == INVALID_INDEX) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "No timer available\n");
+        abort();
+    }
+    self.timers[idx].callback = callback;
+    self.timers[idx].state    = state;
+    self.timers[idx].period   = 0;
+
+    /* A zero it_value disarms the timerfd, so expire right away instead */
+    struct itimerspec spec = {
+            .it_value = {.tv_sec  = timeout / 1000,
+                         .tv_nsec = (timeout % 1000) * NSEC_PER_MSEC + (timeout == 0)},
+    };
+
+    timerfd_settime(self.timers[idx].fd, 0, &spec, NULL);
+}
+
+void *rtos_timer_periodic_start(rart_timer_callback_t callback, const void *state,
+                                uint32_t period, rart_timer_missed_policy_t policy) {
+    if (period == 0 || policy > RART_TIMER_MISSED_DELAY) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "Invalid periodic timer\n");
+        return NULL;
+    }
+
+    rart_index_t idx = search_free_timer();
+
+    if (idx == INVALID_INDEX) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "No timer available\n");
+        return NULL;
+    }
+    self.timers[idx].callback = callback;
+    self.timers[idx].state    = state;
+    self.timers[idx].period   = period;
+    self.timers[idx].policy   = policy;
+    self.timers[idx].missed   = 0;
+
+    /* The kernel keeps the deadlines of an interval timer absolute */
+    struct timespec interval = {.tv_sec  = period / 1000,
+                                .tv_nsec = (period % 1000) * NSEC_PER_MSEC};
+    struct itimerspec spec   = {.it_value = interval, .it_interval = interval};
+
+    timerfd_settime(self.timers[idx].fd, 0, &spec, NULL);
+
+    return &self.timers[idx];
+}
+
+void rtos_timer_periodic_stop(void *timer) {
+    rart_index_t idx = search_timer(timer);
+
+    if (idx == INVALID_INDEX || self.timers[idx].period == 0) {
+        return;
+    }
+
+    struct itimerspec spec = {0};
+
+    /* A callback running late sees the new epoch and leaves the next owner alone */
+    pthread_mutex_lock(&self.timer_lock);
+    timerfd_settime(self.timers[idx].fd, 0, &spec, NULL);
+    self.timers[idx].period = 0;
+    atomic_fetch_add(&self.timers[idx].epoch, 1);
+    atomic_store(&self.timers[idx].is_free, true);
+    pthread_mutex_unlock(&self.timer_lock);
+}
+
+uint32_t rtos_timer_periodic_missed(void *timer) {
+    rart_index_t idx = search_timer(timer);
+
+    return (idx == INVALID_INDEX) ? 0 : self.timers[idx].missed;
+}
+
+/**
+ * @brief Alloc a memory chunk in the heap
+ *
+ * @param align Align of the memory chunk
+ * @param bytes Number of bytes of the memory chunk
+ * @return void* Memory Address
+ */
+const void *heap_alloc(size_t align, size_t bytes) {
+    void *ptr = NULL;
+
+    if (align < sizeof(void *)) {
+        align = sizeof(void *);
+    }
+
+    if (posix_memalign(&ptr, align, bytes) != 0) {
+        RART_LOG_ERR(RART_LOG_MODULE_HEAP, "Allocation error\n");
+        abort();
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief Dealloc a memory chunk in the heap
+ *
+ * @param mem Memory address
+ */
+void heap_free(const void *mem) {
+    free((void *) mem);
+}
+
+static rart_index_t search_free_mutex() {
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        bool is_free = true;
+
+        if (!atomic_compare_exchange_strong(&self.mutexes[i].is_free, &is_free, false)) {
+            continue;
+        }
+
+        if (!self.mutexes[i].is_init) {
+            pthread_mutexattr_t attr;
+
+            self.mutexes[i].is_init = true;
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+            pthread_mutex_init(&self.mutexes[i].mutex, &attr);
+            pthread_mutexattr_destroy(&attr);
+        }
+
+        return i;
+    }
+
+    return INVALID_INDEX;
+}
+
+static rart_index_t search_mutex(pthread_mutex_t *mutex) {
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        if (&self.mutexes[i].mutex == mutex) {
+            return i;
+        }
+    }
+
+    return INVALID_INDEX;
+}
+
+static bool ring_put(struct rart_msgq *msgq, const void *data) {
+    size_t pos = atomic_load_explicit(&msgq->enqueue_pos, memory_order_relaxed);
+
+    for (;;) {
+        size_t cell = pos % NUM_OF_MSG_ITENS;
+        size_t seq  = atomic_load_explicit(&msgq->seq[cell], memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&msgq->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                memcpy(&msgq->buffer[cell * MSG_ITEM_SIZE], data, msgq->item_size);
+                atomic_store_explicit(&msgq->seq[cell], pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&msgq->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static bool ring_get(struct rart_msgq *msgq, void *data_out) {
+    size_t pos = atomic_load_explicit(&msgq->dequeue_pos, memory_order_relaxed);
+
+    for (;;) {
+        size_t cell = pos % NUM_OF_MSG_ITENS;
+        size_t seq  = atomic_load_explicit(&msgq->seq[cell], memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&msgq->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                memcpy(data_out, &msgq->buffer[cell * MSG_ITEM_SIZE], msgq->item_size);
+                atomic_store_explicit(&msgq->seq[cell], pos + NUM_OF_MSG_ITENS,
+                                      memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&msgq->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static bool msgq_wait(struct rart_msgq *msgq, atomic_uint *word, unsigned expected,
+                      uint64_t deadline) {
+    uint64_t now = monotonic_ns();
+
+    if (now >= deadline) {
+        return false;
+    }
+
+    struct timespec remaining = {
+            .tv_sec  = (deadline - now) / (1000 * NSEC_PER_MSEC),
+            .tv_nsec = (deadline - now) % (1000 * NSEC_PER_MSEC),
+    };
+
+    atomic_fetch_add(&msgq->waiters, 1);
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, &remaining, NULL, 0);
+    atomic_fetch_sub(&msgq->waiters, 1);
+
+    return true;
+}
+
+static void msgq_notify(struct rart_msgq *msgq, atomic_uint *word) {
+    atomic_fetch_add(word, 1);
+
+    if (atomic_load(&msgq->waiters) != 0) {
+        syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+static uint64_t monotonic_ns() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 * NSEC_PER_MSEC + now.tv_nsec;
+}
+
+static void *timer_thread(void *arg) {
+    (void) arg;
+    struct epoll_event events[NUM_OF_TIMERS];
+
+    for (;;) {
+        int count = epoll_wait(self.epoll_fd, events, NUM_OF_TIMERS, -1);
+
+        for (int i = 0; i < count; ++i) {
+            rart_index_t idx = events[i].data.u32;
+            unsigned epoch   = atomic_load(&self.timers[idx].epoch);
+            uint64_t expirations;
+
+            if (read(self.timers[idx].fd, &expirations, sizeof(expirations))
+                == sizeof(expirations)) {
+                default_callback(idx, expirations, epoch);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void default_callback(rart_index_t idx, uint64_t expirations, unsigned epoch) {
+    rart_timer_callback_t callback = self.timers[idx].callback;
+    const void *state              = self.timers[idx].state;
+    uint32_t period                = self.timers[idx].period;
+
+    /* Stopped after the expirations were read, the copies may belong to the next owner */
+    if (atomic_load(&self.timers[idx].epoch) != epoch) {
+        return;
+    }
+
+    RART_TRACE(RART_TRACE_WAKE_TIMER, idx, state);
+
+    if (period == 0) {
+        callback(state);
+        atomic_store(&self.timers[idx].is_free, true);
+        return;
+    }
+
+    uint64_t calls = 1;
+
+    if (expirations > 1) {
+        self.timers[idx].missed += expirations - 1;
+
+        if (self.timers[idx].policy == RART_TIMER_MISSED_BURST) {
+            calls = expirations;
+        } else if (self.timers[idx].policy == RART_TIMER_MISSED_DELAY) {
+            struct timespec interval = {.tv_sec  = period / 1000,
+                                        .tv_nsec = (period % 1000) * NSEC_PER_MSEC};
+            struct itimerspec spec   = {.it_value = interval, .it_interval = interval};
+
+            /* Never re-arm the timerfd once it was stopped, it may have a new owner */
+            pthread_mutex_lock(&self.timer_lock);
+            if (atomic_load(&self.timers[idx].epoch) == epoch) {
+                timerfd_settime(self.timers[idx].fd, 0, &spec, NULL);
+            }
+            pthread_mutex_unlock(&self.timer_lock);
+        }
+    }
+
+    /* The callback may stop the timer, and another one may start on the same slot */
+    for (; calls > 0 && atomic_load(&self.timers[idx].epoch) == epoch; --calls) {
+        callback(state);
+    }
+}
+
+static rart_index_t search_timer(const void *timer) {
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        if (timer == &self.timers[i]) {
+            return i;
+        }
+    }
+
+    return INVALID_INDEX;
+}
+
+static rart_index_t search_free_timer() {
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        bool is_free = true;
+
+        if (atomic_compare_exchange_strong(&self.timers[i].is_free, &is_free, false)) {
+            return i;
+        }
+    }
+
+    return INVALID_INDEX;
+}
+
+static void log_vprint(uint8_t level, const char *format, va_list va) {
+    static const char *const tags[] = {
+            [RART_LOG_LEVEL_NONE] = "",
+            [RART_LOG_LEVEL_ERR]  = "[err]",
+            [RART_LOG_LEVEL_WRN]  = "[wrn]",
+            [RART_LOG_LEVEL_INF]  = "[log]",
+            [RART_LOG_LEVEL_DBG]  = "[trace]",
+    };
+
+    printf("%s", tags[level <= RART_LOG_LEVEL_DBG ? level : RART_LOG_LEVEL_NONE]);
+    vprintf(format, va);
+}
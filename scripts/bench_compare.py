@@ -0,0 +1,109 @@
+"""Compare RART benchmark results against a stored baseline.
+
+Both files are JSON objects with the measured operations:
+
+    {
+        "board": "qemu_cortex_m3",
+        "results": {
+            "mutex_lock_unlock_uncontended": {"value": 412, "unit": "cycles"},
+            "msgq_send_recv_8": {"value": 1380, "unit": "cycles"}
+        }
+    }
+
+The results can also be the console log of a Zephyr run of the tests/zephyr bench
+suite, which prints them between RART-BENCH-BEGIN and RART-BENCH-END lines.
+
+Lower values are better. An operation regresses when its value grows more than the
+threshold, in percent, over the baseline; over a baseline of 0, any growth regresses.
+An operation of the baseline missing from the results also fails, so a benchmark that
+stops running is not mistaken for a clean run. The script exits with 1 on any failure,
+so it can gate a CI job.
+
+The results come from the rart-bench target of tests/CMakeLists.txt on the host, or
+from the rart.bench scenario of tests/zephyr on native_sim and qemu_cortex_m3.
+"""
+import argparse
+import json
+import sys
+
+parser = argparse.ArgumentParser(description='Compare RART benchmark results against a baseline')
+
+parser.add_argument('results', action='store', type=str)
+parser.add_argument('baseline', action='store', type=str)
+parser.add_argument('-t', '--threshold', action='store', type=float, default=10.0,
+                    help='Allowed growth over the baseline, in percent')
+parser.add_argument('-o', '--override', action='append', default=[], metavar='NAME=PERCENT',
+                    help='Threshold of a single operation')
+parser.add_argument('-u', '--update', action='store_true',
+                    help='Replace the baseline with the results when there is no regression')
+
+args = parser.parse_args()
+
+
+def load(path):
+    """Load benchmark results from a JSON file or from a console log"""
+    with open(path) as file:
+        text = file.read()
+
+    begin = text.find('RART-BENCH-BEGIN')
+    if begin >= 0:
+        end = text.find('RART-BENCH-END', begin)
+        if end < 0:
+            sys.exit(f'error: {path} has no RART-BENCH-END line')
+        text = text[begin + len('RART-BENCH-BEGIN'):end]
+
+    return json.loads(text)
+
+
+thresholds = {}
+for override in args.override:
+    name, _, percent = override.partition('=')
+    if not percent:
+        parser.error(f'invalid override "{override}", expected NAME=PERCENT')
+    thresholds[name] = float(percent)
+
+results = load(args.results)
+baseline = load(args.baseline)
+
+if results.get('board') != baseline.get('board'):
+    print(f'warning: comparing {results.get("board")} results against a '
+          f'{baseline.get("board")} baseline')
+
+regressions = 0
+print(f'{"operation":<40} {"baseline":>12} {"current":>12} {"change":>9}')
+for name, current in sorted(results['results'].items()):
+    reference = baseline['results'].get(name)
+    if reference is None:
+        print(f'{name:<40} {"-":>12} {current["value"]:>12} {"new":>9}')
+        continue
+
+    if reference['value'] != 0:
+        change = (current['value'] - reference['value']) * 100.0 / reference['value']
+    elif current['value'] > 0:
+        change = float('inf')
+    else:
+        change = 0.0
+    limit = thresholds.get(name, args.threshold)
+    status = ''
+    if change > limit:
+        status = f'  REGRESSION (> {limit:g}%)'
+        regressions += 1
+
+    print(f'{name:<40} {reference["value"]:>12} {current["value"]:>12} {change:>+8.1f}%{status}')
+
+missing = sorted(set(baseline['results']) - set(results['results']))
+for name in missing:
+    print(f'{name:<40} {baseline["results"][name]["value"]:>12} {"-":>12} {"missing":>9}')
+
+if regressions:
+    print(f'{regressions} operation(s) regressed')
+if missing:
+    print(f'{len(missing)} operation(s) missing from the results')
+if regressions or missing:
+    sys.exit(1)
+
+if args.update:
+    with open(args.baseline, 'w') as file:
+        json.dump(results, file, indent=4)
+        file.write('\n')
+    print(f'Baseline {args.baseline} updated')
@@ -1,6 +1,7 @@
 from string import Template
 import argparse
 import os
+import sys
 
 parser = argparse.ArgumentParser(description='Generate the files based on Rust User Library')
 
@@ -8,9 +9,35 @@ parser.add_argument('-d', '--dir', action='store', type=str)
 parser.add_argument('-t', '--task_amount', action='store', type=int, required=True)
 parser.add_argument('-n', '--task_names', action='store', nargs='+', required=True)
 parser.add_argument('-z', '--zbus_observer_amount', action='store', type=int)
+parser.add_argument('-c', '--zbus_channel_amount', action='store', type=int,
+                    help='Number of ZBUS channels. Without -c or -C the backend counts the '
+                         'channels of zbus_channels.h')
+parser.add_argument('-s', '--zbus_subscriber_amount', action='store', type=int, default=0)
+parser.add_argument('-q', '--zbus_subscriber_queue_depth', action='store', type=int, default=4)
+parser.add_argument('-w', '--zbus_publish_waiters', action='store', type=int, default=4,
+                    help='Publishers that can wait for a busy channel at the same time')
+parser.add_argument('-m', '--manifest', action='store', type=str,
+                    help='TOML file with the pool sizes of the backend')
+parser.add_argument('-S', '--static_objects', action='store_true',
+                    help='Define the Zephyr kernel objects and task threads at build time. '
+                         'The threads take their settings from [task] of the manifest')
+parser.add_argument('-C', '--zbus_channels', action='store', type=str,
+                    help='TOML file describing the ZBUS channels, replaces -c')
 
 args = parser.parse_args()
 
+
+def load_toml(path):
+    """Load a TOML file. tomllib is only needed, and imported, when a file is given."""
+    try:
+        import tomllib
+    except ModuleNotFoundError:
+        sys.exit(f'error: reading {path} needs Python 3.11 or newer, for tomllib')
+
+    with open(path, 'rb') as file:
+        return tomllib.load(file)
+
+
 directory = '../../../src/generated'
 if args.dir:
     directory = os.path.abspath(args.dir)
@@ -21,6 +48,70 @@ if not os.path.exists(directory):
 if directory[-1] != '/' and directory[-1] != '\\':
     directory += '/'
 
+# Estimated size, in bytes, of each kernel object on a 32 bit Zephyr target, with the
+# flags the backend keeps next to it. Only used for the RAM budget report.
+OBJECT_SIZES = {'mutex': 24, 'msgq': 44, 'timer': 64}
+
+# Manifest key of each pool define, with the default derived from the number of tasks
+POOLS = {
+    'NUM_OF_MUTEXES': ('mutex', 'count', 7 * args.task_amount),
+    'NUM_OF_MSGQ': ('msgq', 'count', 4 * args.task_amount),
+    'NUM_OF_MSG_ITENS': ('msgq', 'depth', 8),
+    'MSG_ITEM_SIZE': ('msgq', 'item_size', 8),
+    'NUM_OF_TIMERS': ('timer', 'count', args.task_amount),
+    'HEAP_TOTAL': ('heap', 'size', 2048),
+    'MSGQ_POOL_SIZE': ('msgq', 'pool_size', None),
+}
+
+pools = {define: default for define, (_, _, default) in POOLS.items()}
+budget = None
+# Thread settings of the tasks with -S: the defaults, updated by [task] of the manifest,
+# and the settings of each task, from [task.<name>]. A task with autostart = false is
+# created but not started, the application starts it with k_thread_start(<name>_id).
+task = {'stack_size': 1024, 'priority': 7, 'autostart': True}
+tasks = {}
+
+
+def check_task(section, options):
+    """Check the thread settings of a [task] section of the manifest"""
+    for key, value in options.items():
+        if key not in task:
+            parser.error(f'{section}.{key} of {args.manifest} is not a task setting')
+        if key == 'stack_size' and (not isinstance(value, int) or isinstance(value, bool)
+                                    or value <= 0):
+            parser.error(f'{section}.{key} of {args.manifest} must be a positive integer')
+        if key == 'priority' and (not isinstance(value, int) or isinstance(value, bool)):
+            parser.error(f'{section}.{key} of {args.manifest} must be an integer')
+        if key == 'autostart' and not isinstance(value, bool):
+            parser.error(f'{section}.{key} of {args.manifest} must be true or false')
+
+    return options
+
+
+if args.manifest:
+    manifest = load_toml(args.manifest)
+
+    for define, (section, key, _) in POOLS.items():
+        value = manifest.get(section, {}).get(key)
+        if value is None:
+            continue
+        if not isinstance(value, int) or value <= 0:
+            parser.error(f'{section}.{key} of {args.manifest} must be a positive integer')
+        if key == 'count' and value >= 65535:
+            parser.error(f'{section}.{key} of {args.manifest} must be lower than 65535')
+        pools[define] = value
+
+    task_options = manifest.get('task', {})
+    for key, value in task_options.items():
+        if isinstance(value, dict):
+            if key not in args.task_names:
+                parser.error(f'task.{key} of {args.manifest} is not one of the task names')
+            tasks[key] = check_task(f'task.{key}', value)
+        else:
+            task.update(check_task('task', {key: value}))
+
+    budget = manifest.get('budget', {}).get('ram')
+
 rart_defines_file = directory + 'rart-defines.h'
 with open(rart_defines_file, 'w') as file:
     t = Template("""/**
@@ -33,16 +124,120 @@ with open(rart_defines_file, 'w') as file:
 #define RART_DEFINES_H
 
 #define NUM_OF_TASKS $task_num
-$task_list
+$pool_list$static_objects$task_list
 #endif  /* RART_DEFINES_H */""")
     task_list = ''
     for name in args.task_names:
         task_list += f'\nvoid {name}(void);\n'
 
-    content = t.substitute(task_num=args.task_amount, task_list=task_list)
+    pool_list = ''
+    if args.manifest or args.static_objects:
+        pool_list += '\n'
+        for define, value in pools.items():
+            if value is not None:
+                pool_list += f'#define {define} {value}\n'
+
+    static_objects = '\n#define RART_STATIC_OBJECTS\n' if args.static_objects else ''
+
+    content = t.substitute(task_num=args.task_amount, pool_list=pool_list,
+                           static_objects=static_objects, task_list=task_list)
     file.write(content)
 
+if args.static_objects:
+    rart_objects_file = directory + 'rart-objects.h'
+    with open(rart_objects_file, 'w') as file:
+        t = Template("""/**
+ * @file rart-objects.h
+ * @brief File generated with the Zephyr kernel objects of RART, included by the backend
+ * @version 0.1
+ */
+
+#ifndef RART_OBJECTS_H
+#define RART_OBJECTS_H
+$mutex_list
+static struct k_mutex *const rart_mutexes[] = {$mutex_table
+};
+$timer_list
+static struct k_timer *const rart_timers[] = {$timer_table
+};
+$thread_list
+#endif  /* RART_OBJECTS_H */""")
+        mutexes = [f'rart_mutex_{i}' for i in range(pools['NUM_OF_MUTEXES'])]
+        timers = [f'rart_timer_{i}' for i in range(pools['NUM_OF_TIMERS'])]
+
+        mutex_list = ''.join(f'\nK_MUTEX_DEFINE({name});' for name in mutexes)
+        timer_list = ''.join(f'\nK_TIMER_DEFINE({name}, default_callback, NULL);'
+                             for name in timers)
+        thread_list = ''
+        for name in args.task_names:
+            settings = {**task, **tasks.get(name, {})}
+            delay = '0' if settings['autostart'] else 'SYS_FOREVER_MS'
+            thread_list += (f'\nK_THREAD_DEFINE({name}_id, {settings["stack_size"]}, {name}, '
+                            f'NULL, NULL, NULL, {settings["priority"]}, 0, {delay});\n')
+
+        content = t.substitute(mutex_list=mutex_list + '\n',
+                               mutex_table=''.join(f'\n        &{name},' for name in mutexes),
+                               timer_list=timer_list + '\n',
+                               timer_table=''.join(f'\n        &{name},' for name in timers),
+                               thread_list=thread_list)
+        file.write(content)
+
+report = [
+    ('mutexes', pools['NUM_OF_MUTEXES'], pools['NUM_OF_MUTEXES'] * OBJECT_SIZES['mutex']),
+    ('message queues', pools['NUM_OF_MSGQ'], pools['NUM_OF_MSGQ'] * OBJECT_SIZES['msgq']),
+    ('queue storage', 1, pools.get('MSGQ_POOL_SIZE')
+     or pools['NUM_OF_MSGQ'] * pools['NUM_OF_MSG_ITENS'] * pools['MSG_ITEM_SIZE']),
+    ('timers', pools['NUM_OF_TIMERS'], pools['NUM_OF_TIMERS'] * OBJECT_SIZES['timer']),
+    ('heap', 1, pools['HEAP_TOTAL']),
+]
+total = sum(size for _, _, size in report)
+
+with open(directory + 'rart-ram-budget.txt', 'w') as file:
+    file.write('RART RAM budget (estimated for a 32 bit target)\n\n')
+    file.write(f'{"pool":<16} {"count":>6} {"bytes":>8}\n')
+    for name, count, size in report:
+        file.write(f'{name:<16} {count:>6} {size:>8}\n')
+    file.write(f'{"total":<16} {"":>6} {total:>8}\n')
+    if budget:
+        file.write(f'{"budget":<16} {"":>6} {budget:>8}\n')
+
+with open(directory + 'rart-ram-budget.txt') as file:
+    print(file.read(), end='')
+
+if budget and total > budget:
+    print(f'error: RART pools need {total} bytes, over the budget of {budget}')
+    sys.exit(1)
+
+channels = []
+if args.zbus_channels:
+    description = load_toml(args.zbus_channels)
+
+    for i, channel in enumerate(description.get('channel', [])):
+        if 'name' not in channel or 'size' not in channel:
+            parser.error(f'channel {i} of {args.zbus_channels} needs a name and a size')
+        if not channel['name'].isidentifier():
+            parser.error(f'invalid channel name "{channel["name"]}"')
+        if not isinstance(channel['size'], int) or channel['size'] <= 0:
+            parser.error(f'size of channel {channel["name"]} must be a positive integer')
+        channels.append({'name': channel['name'].upper(),
+                         'size': channel['size'],
+                         'observers': channel.get('observers', 1)})
+
+    if not channels:
+        parser.error(f'{args.zbus_channels} has no [[channel]]')
+    if len({channel['name'] for channel in channels}) != len(channels):
+        parser.error(f'{args.zbus_channels} has repeated channel names')
+
+    args.zbus_channel_amount = len(channels)
+    if not args.zbus_observer_amount:
+        args.zbus_observer_amount = sum(channel['observers'] for channel in channels)
+
 if args.zbus_observer_amount:
+    if args.zbus_channel_amount is not None and args.zbus_channel_amount <= 0:
+        parser.error('--zbus_channel_amount must be a positive integer')
+    if args.zbus_publish_waiters <= 0:
+        parser.error('--zbus_publish_waiters must be a positive integer')
+
     zbus_backend_defines_file = directory + 'zbus-backend-defines.h'
     with open(zbus_backend_defines_file, 'w') as file:
         t = Template("""/**
@@ -55,7 +250,49 @@ if args.zbus_observer_amount:
 #define ZBUS_BACKEND_DEFINES_H
 
 #define NUM_OF_OBSERVERS $observer_num
+$channel_num
+#define NUM_OF_SUBSCRIBERS $subscriber_num
 
+#define SUBSCRIBER_QUEUE_DEPTH $queue_depth
+
+#define NUM_OF_PUBLISH_WAITERS $waiter_num
+$channel_table
 #endif  /* ZBUS_BACKEND_DEFINES_H */""")
-        content = t.substitute(observer_num=args.zbus_observer_amount)
+        channel_table = ''
+        if channels:
+            channel_table += '\nenum zbus_backend_channel_id {\n'
+            for i, channel in enumerate(channels):
+                channel_table += f'    ZBUS_BACKEND_CHAN_{channel["name"]} = {i},\n'
+            channel_table += '};\n'
+            sizes = ', '.join(str(channel['size']) for channel in channels)
+            channel_table += f'\n#define CHANNEL_MESSAGE_SIZES {{{sizes}}}\n'
+            channel_table += ('\n#define CHANNEL_MESSAGE_SIZE_MAX '
+                              f'{max(channel["size"] for channel in channels)}\n')
+
+        # Without a channel count, the backend counts the channels of zbus_channels.h
+        channel_num = ''
+        if args.zbus_channel_amount:
+            channel_num = f'\n#define NUM_OF_CHANNELS {args.zbus_channel_amount}\n'
+
+        content = t.substitute(observer_num=args.zbus_observer_amount,
+                               channel_num=channel_num,
+                               subscriber_num=args.zbus_subscriber_amount,
+                               queue_depth=args.zbus_subscriber_queue_depth,
+                               waiter_num=args.zbus_publish_waiters,
+                               channel_table=channel_table)
+        file.write(content)
+
+if channels:
+    zbus_channels_file = directory + 'zbus_channels.rs'
+    with open(zbus_channels_file, 'w') as file:
+        t = Template("""//! File generated with the ZBUS channel description for RART-rs
+
+pub const NUM_OF_CHANNELS: u32 = $channel_num;
+$channel_list""")
+        channel_list = ''
+        for i, channel in enumerate(channels):
+            channel_list += f'\npub const CHAN_{channel["name"]}: u32 = {i};\n'
+            channel_list += f'pub const CHAN_{channel["name"]}_SIZE: usize = {channel["size"]};\n'
+
+        content = t.substitute(channel_num=len(channels), channel_list=channel_list)
         file.write(content)
@@ -0,0 +1,82 @@
+/**
+ * @file bench.c
+ * @brief Benchmark results of the RART suite, shared by the host and Zephyr harnesses
+ * @version 0.1
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "rart-test.h"
+
+/**
+ * @brief Maximum number of benchmark results of a run
+ */
+#define BENCH_MAX_RESULTS 32
+
+/**
+ * @brief Benchmark result
+ */
+typedef struct {
+    const char *name; /**< Operation measured */
+    const char *unit; /**< Unit of the value */
+    uint64_t value;   /**< Cost of one operation */
+} bench_result_t;
+
+/**
+ * @brief Results recorded since the last rart_bench_json
+ */
+static struct {
+    bench_result_t result[BENCH_MAX_RESULTS]; /**< Results, in report order */
+    size_t count;                             /**< Number of results */
+} bench;
+
+void rart_bench_report(const char *name, uint64_t value, const char *unit) {
+    size_t i = 0;
+
+    while (i < bench.count && strcmp(bench.result[i].name, name) != 0) {
+        ++i;
+    }
+
+    if (i == BENCH_MAX_RESULTS) {
+        printf("    too many benchmark results, %s dropped\n", name);
+        return;
+    }
+
+    bench.result[i].name  = name;
+    bench.result[i].unit  = (unit != NULL) ? unit : RART_BENCH_UNIT;
+    bench.result[i].value = value;
+    if (i == bench.count) {
+        bench.count++;
+    }
+
+    printf("    %s: %llu %s\n", name, (unsigned long long) value, bench.result[i].unit);
+}
+
+size_t rart_bench_json(char *buffer, size_t size, const char *board) {
+    size_t len = 0;
+
+    if (bench.count == 0) {
+        return 0;
+    }
+
+    len += snprintf(buffer + len, size - len, "{\n    \"board\": \"%s\",\n    \"results\": {",
+                    board);
+    for (size_t i = 0; i < bench.count && len < size; ++i) {
+        len += snprintf(buffer + len, size - len,
+                        "%s\n        \"%s\": {\"value\": %llu, \"unit\": \"%s\"}",
+                        (i == 0) ? "" : ",", bench.result[i].name,
+                        (unsigned long long) bench.result[i].value, bench.result[i].unit);
+    }
+    if (len < size) {
+        len += snprintf(buffer + len, size - len, "\n    }\n}\n");
+    }
+
+    if (len >= size) {
+        printf("    benchmark results do not fit in %u bytes\n", (unsigned) size);
+        return 0;
+    }
+
+    bench.count = 0;
+
+    return len;
+}
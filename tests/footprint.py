@@ -0,0 +1,74 @@
+"""Footprint test of the RART pools generated for 4, 16, 32 and 64 tasks.
+
+Runs scripts/gen_files.py with the default pools of each task count and prints the
+message queue storage of its RAM budget next to the storage of the old layout, where
+each of the 4 * tasks queues embedded 4 * tasks items. Fails if the storage is not
+linear in the number of queues, or if the generator stops reporting it.
+
+    python3 tests/footprint.py [--item-size BYTES]
+"""
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+TASKS = [4, 16, 32, 64]
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+parser = argparse.ArgumentParser(description='Print the RART RAM budget for several task counts')
+parser.add_argument('--item-size', action='store', type=int, default=8,
+                    help='Message queue item size of the old layout, in bytes')
+
+args = parser.parse_args()
+
+
+def budget(tasks):
+    """Run the generator for a number of tasks and parse its RAM budget"""
+    names = [f'task_{i}' for i in range(tasks)]
+
+    with tempfile.TemporaryDirectory() as directory:
+        subprocess.run([sys.executable, os.path.join(ROOT, 'scripts', 'gen_files.py'),
+                        '-d', directory, '-t', str(tasks), '-n', *names],
+                       check=True, stdout=subprocess.DEVNULL)
+        with open(os.path.join(directory, 'rart-ram-budget.txt')) as file:
+            lines = file.read().splitlines()
+
+    pools = {}
+    for line in lines:
+        fields = line.rsplit(maxsplit=2)
+        if len(fields) == 3 and fields[1].isdigit() and fields[2].isdigit():
+            pools[fields[0]] = (int(fields[1]), int(fields[2]))
+        elif len(fields) == 2 and fields[0] == 'total':
+            pools['total'] = (1, int(fields[1]))
+
+    return pools
+
+
+failures = 0
+per_queue = set()
+print(f'{"tasks":>5} {"queues":>7} {"storage before":>15} {"storage after":>14} '
+      f'{"total after":>12}')
+for tasks in TASKS:
+    pools = budget(tasks)
+    if 'queue storage' not in pools or 'message queues' not in pools:
+        print(f'error: no queue storage in the budget of {tasks} tasks')
+        failures += 1
+        continue
+
+    queues = pools['message queues'][0]
+    before = 4 * tasks * 4 * tasks * args.item_size
+    after = pools['queue storage'][1]
+    per_queue.add(after / queues)
+    print(f'{tasks:>5} {queues:>7} {before:>15} {after:>14} {pools["total"][1]:>12}')
+
+    if after >= before:
+        print(f'error: queue storage of {tasks} tasks did not shrink')
+        failures += 1
+
+# Linear: every queue gets the same storage, whatever the number of tasks
+if len(per_queue) > 1:
+    print(f'error: queue storage per queue depends on the number of tasks: {per_queue}')
+    failures += 1
+
+sys.exit(1 if failures else 0)
@@ -0,0 +1,228 @@
+/**
+ * @file main.c
+ * @brief Host runner of the RART backend conformance and performance suite
+ * @version 0.1
+ *
+ * Runs the tests registered with RART_TEST in registration order, which is the order of
+ * the source, after the setup of their suite. Usage:
+ *
+ *     rart-test-<suite> [--bench FILE] [--board NAME]
+ *
+ * The benchmark results are written to FILE in the format of scripts/bench_compare.py.
+ */
+#define _GNU_SOURCE
+#include <sched.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rart-test.h"
+
+/**
+ * @brief Size of the benchmark results, in JSON
+ */
+#define BENCH_JSON_SIZE 4096
+
+/**
+ * @brief Entry point and argument of a test thread
+ */
+typedef struct {
+    rart_test_thread_fn_t fn; /**< Entry point */
+    void *arg;                /**< Argument of the entry point */
+} thread_entry_t;
+
+/**
+ * @brief State of the runner
+ */
+static struct {
+    struct rart_test *head;          /**< First test */
+    struct rart_test *tail;          /**< Last test */
+    struct rart_test_suite *suites;  /**< Registered suites */
+    jmp_buf test_exit;               /**< Exit of the running test on a failure */
+    const char *bench_file;          /**< File of the benchmark results, or NULL */
+    const char *board;               /**< Board written with the benchmark results */
+} runner = {.board = "posix"};
+
+/**
+ * @brief Adapt the entry point of a test thread to pthread_create
+ *
+ * @param arg[in] Entry of the thread, freed here
+ * @return void* NULL
+ */
+static void *thread_entry(void *arg);
+
+/**
+ * @brief Run the setup of a suite, once
+ *
+ * @param name[in] Suite name
+ */
+static void suite_setup(const char *name);
+
+/**
+ * @brief Run a test and report its result
+ *
+ * @param test[in] Test
+ * @return bool True if the test passed.
+ */
+static bool run_test(struct rart_test *test);
+
+void rart_test_register(struct rart_test *test) {
+    if (runner.tail == NULL) {
+        runner.head = test;
+    } else {
+        runner.tail->next = test;
+    }
+    runner.tail = test;
+}
+
+void rart_test_register_suite(struct rart_test_suite *suite) {
+    suite->next   = runner.suites;
+    runner.suites = suite;
+}
+
+void rart_test_fail(const char *file, int line, const char *format, ...) {
+    va_list args;
+
+    printf("    %s:%d: ", file, line);
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+
+    longjmp(runner.test_exit, 1);
+}
+
+void rart_test_thread_start(rart_test_thread_t *thread, rart_test_thread_fn_t fn, void *arg) {
+    thread_entry_t *entry = malloc(sizeof(thread_entry_t));
+
+    if (entry == NULL) {
+        panic("Test thread allocation failed\n");
+    }
+    entry->fn  = fn;
+    entry->arg = arg;
+
+    if (pthread_create(&thread->thread, NULL, thread_entry, entry) != 0) {
+        panic("Test thread creation failed\n");
+    }
+}
+
+void rart_test_thread_join(rart_test_thread_t *thread) {
+    pthread_join(thread->thread, NULL);
+}
+
+void rart_test_sleep(uint32_t ms) {
+    struct timespec time = {.tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L};
+
+    while (nanosleep(&time, &time) != 0) {
+    }
+}
+
+void rart_test_yield(void) {
+    sched_yield();
+}
+
+void rart_test_busy_wait(uint32_t us) {
+    uint64_t end = rart_test_now_us() + us;
+
+    while (rart_test_now_us() < end) {
+    }
+}
+
+uint64_t rart_test_now_us(void) {
+    return rart_bench_now() / 1000;
+}
+
+uint64_t rart_bench_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+void rart_bench_flush(void) {
+    static char json[BENCH_JSON_SIZE];
+    size_t len = rart_bench_json(json, sizeof(json), runner.board);
+
+    if (len == 0 || runner.bench_file == NULL) {
+        return;
+    }
+
+    FILE *file = fopen(runner.bench_file, "w");
+
+    if (file == NULL || fwrite(json, 1, len, file) != len) {
+        panic("Cannot write %s\n", runner.bench_file);
+    }
+    fclose(file);
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            runner.bench_file = argv[++i];
+        } else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+            runner.board = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--bench FILE] [--board NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    /* Keep the output ordered with the output of the backend */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    unsigned passed = 0;
+    unsigned failed = 0;
+
+    for (struct rart_test *test = runner.head; test != NULL; test = test->next) {
+        suite_setup(test->suite);
+        if (run_test(test)) {
+            passed++;
+        } else {
+            failed++;
+        }
+    }
+
+    rart_bench_flush();
+    printf("%u passed, %u failed\n", passed, failed);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void suite_setup(const char *name) {
+    for (struct rart_test_suite *suite = runner.suites; suite != NULL; suite = suite->next) {
+        if (strcmp(suite->name, name) == 0 && suite->setup != NULL) {
+            suite->setup();
+            suite->setup = NULL;
+        }
+    }
+}
+
+static bool run_test(struct rart_test *test) {
+    printf("RUN  %s.%s\n", test->suite, test->name);
+
+    uint64_t start = rart_test_now_us();
+
+    if (setjmp(runner.test_exit) != 0) {
+        printf("FAIL %s.%s\n", test->suite, test->name);
+        return false;
+    }
+
+    test->fn();
+    printf("PASS %s.%s (%llu ms)\n", test->suite, test->name,
+           (unsigned long long) (rart_test_now_us() - start) / 1000);
+
+    return true;
+}
+
+static void *thread_entry(void *arg) {
+    thread_entry_t entry = *(thread_entry_t *) arg;
+
+    free(arg);
+    entry.fn(entry.arg);
+
+    return NULL;
+}
@@ -0,0 +1,266 @@
+/**
+ * @file rart-test.h
+ * @brief Harness of the RART backend conformance and performance suite
+ * @version 0.1
+ *
+ * The tests only use the backend ABI and this header, so every backend runs the same
+ * suite. On Zephyr the macros map to ztest, on a host they map to the runner of
+ * tests/host. Assertions are only valid in the test body, the threads started by a
+ * test report their results through variables checked by the test.
+ *
+ * @code
+ * RART_TEST_SUITE(rart_mutex, NULL);
+ *
+ * RART_TEST(rart_mutex, lock_unlock) {
+ *     void *mutex = rtos_mutex_new();
+ *
+ *     RART_ASSERT_NOT_NULL(mutex);
+ *     RART_ASSERT_EQ(rtos_mutex_lock(mutex, 0), 0);
+ * }
+ * @endcode
+ */
+
+#ifndef RART_TEST_H
+#define RART_TEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rart.h"
+
+/**
+ * @brief Type of the entry point of a test thread
+ *
+ * @param arg Argument given to rart_test_thread_start
+ */
+typedef void (*rart_test_thread_fn_t)(void *arg);
+
+#if defined(__ZEPHYR__)
+#include <ztest.h>
+
+/**
+ * @brief Threads of the Zephyr harness, each with its own stack
+ */
+#define RART_TEST_THREADS 8
+
+/**
+ * @brief Thread started by a test
+ */
+typedef struct {
+    struct k_thread thread; /**< Zephyr thread */
+    int slot;               /**< Stack of the thread */
+} rart_test_thread_t;
+
+#define RART_TEST_SUITE(suite, setup_fn)                                                 \
+    static void *suite##_setup(void) {                                                   \
+        void (*fn)(void) = (setup_fn);                                                   \
+        if (fn != NULL) {                                                                \
+            fn();                                                                        \
+        }                                                                                \
+        return NULL;                                                                     \
+    }                                                                                    \
+    static void suite##_teardown(void *fixture) {                                        \
+        ARG_UNUSED(fixture);                                                             \
+        rart_bench_flush();                                                              \
+    }                                                                                    \
+    ZTEST_SUITE(suite, NULL, suite##_setup, NULL, NULL, suite##_teardown)
+
+#define RART_TEST(suite, name) ZTEST(suite, name)
+
+#define RART_ASSERT(cond, ...)       zassert_true(cond, __VA_ARGS__)
+#define RART_ASSERT_EQ(a, b)         zassert_equal(a, b, "%s != %s", #a, #b)
+#define RART_ASSERT_NOT_NULL(ptr)    zassert_not_null(ptr, "%s is NULL", #ptr)
+#define RART_ASSERT_NULL(ptr)        zassert_is_null(ptr, "%s is not NULL", #ptr)
+#define RART_ASSERT_WITHIN(a, b, d)  zassert_within(a, b, d, "%s not within %s", #a, #b)
+
+/**
+ * @brief Unit of the values measured with rart_bench_now
+ */
+#define RART_BENCH_UNIT "cycles"
+
+#else
+#include <pthread.h>
+
+/**
+ * @brief Thread started by a test
+ */
+typedef struct {
+    pthread_t thread; /**< POSIX thread */
+} rart_test_thread_t;
+
+/**
+ * @brief Test registered in the host runner
+ */
+struct rart_test {
+    const char *suite;        /**< Suite name */
+    const char *name;         /**< Test name */
+    void (*fn)(void);         /**< Test body */
+    struct rart_test *next;   /**< Next test, in registration order */
+};
+
+/**
+ * @brief Suite registered in the host runner
+ */
+struct rart_test_suite {
+    const char *name;              /**< Suite name */
+    void (*setup)(void);           /**< Called once before the first test, or NULL */
+    struct rart_test_suite *next;  /**< Next suite */
+};
+
+/**
+ * @brief Add a test to the host runner. Called by RART_TEST before main.
+ *
+ * @param test[in] Test, kept by the runner
+ */
+void rart_test_register(struct rart_test *test);
+
+/**
+ * @brief Add a suite to the host runner. Called by RART_TEST_SUITE before main.
+ *
+ * @param suite[in] Suite, kept by the runner
+ */
+void rart_test_register_suite(struct rart_test_suite *suite);
+
+/**
+ * @brief Report a failed assertion and leave the current test. It never returns.
+ *
+ * @param file[in] File of the assertion
+ * @param line Line of the assertion
+ * @param format Formatted string describing the failure
+ * @param ... Variable arguments
+ */
+void rart_test_fail(const char *file, int line, const char *format, ...)
+        __attribute__((noreturn, format(printf, 3, 4)));
+
+#define RART_TEST_SUITE(suite, setup_fn)                                                 \
+    static struct rart_test_suite suite##_suite = {.name = #suite, .setup = (setup_fn)}; \
+    __attribute__((constructor)) static void suite##_register(void) {                    \
+        rart_test_register_suite(&suite##_suite);                                        \
+    }
+
+#define RART_TEST(suite, name)                                                           \
+    static void suite##_##name(void);                                                    \
+    static struct rart_test suite##_##name##_test = {#suite, #name, suite##_##name, NULL}; \
+    __attribute__((constructor)) static void suite##_##name##_register(void) {           \
+        rart_test_register(&suite##_##name##_test);                                      \
+    }                                                                                    \
+    static void suite##_##name(void)
+
+#define RART_ASSERT(cond, ...)                                                           \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            rart_test_fail(__FILE__, __LINE__, __VA_ARGS__);                             \
+        }                                                                                \
+    } while (0)
+
+#define RART_ASSERT_EQ(a, b)                                                             \
+    RART_ASSERT((a) == (b), "%s == %lld, expected %s == %lld", #a, (long long) (a), #b,   \
+                (long long) (b))
+#define RART_ASSERT_NOT_NULL(ptr) RART_ASSERT((ptr) != NULL, "%s is NULL", #ptr)
+#define RART_ASSERT_NULL(ptr)     RART_ASSERT((ptr) == NULL, "%s is not NULL", #ptr)
+#define RART_ASSERT_WITHIN(a, b, d)                                                      \
+    RART_ASSERT((a) >= (b) - (d) && (a) <= (b) + (d), "%s == %lld, not within %lld of %s", \
+                #a, (long long) (a), (long long) (d), #b)
+
+/**
+ * @brief Unit of the values measured with rart_bench_now
+ */
+#define RART_BENCH_UNIT "ns"
+
+#endif
+
+/**
+ * @brief Start a thread running a function
+ *
+ * @param thread[out] Thread
+ * @param fn[in] Entry point of the thread
+ * @param arg[in] Argument passed to the entry point
+ */
+void rart_test_thread_start(rart_test_thread_t *thread, rart_test_thread_fn_t fn, void *arg);
+
+/**
+ * @brief Wait for a thread to return
+ *
+ * @param thread[in,out] Thread started with rart_test_thread_start
+ */
+void rart_test_thread_join(rart_test_thread_t *thread);
+
+/**
+ * @brief Suspend the caller
+ *
+ * @param ms Time to sleep, in milliseconds
+ */
+void rart_test_sleep(uint32_t ms);
+
+/**
+ * @brief Give the CPU to another ready thread of the same priority
+ */
+void rart_test_yield(void);
+
+/**
+ * @brief Spin without giving the CPU away. Also valid in timer callbacks.
+ *
+ * @param us Time to spin, in microseconds
+ */
+void rart_test_busy_wait(uint32_t us);
+
+/**
+ * @brief Get a monotonic time
+ *
+ * @return uint64_t Time since an arbitrary origin, in microseconds
+ */
+uint64_t rart_test_now_us(void);
+
+/**
+ * @brief Get the finest monotonic counter of the target, for the benchmarks
+ *
+ * @return uint64_t Counter, in RART_BENCH_UNIT
+ */
+uint64_t rart_bench_now(void);
+
+/**
+ * @brief Record the result of a benchmark. A result recorded twice keeps the last value.
+ *
+ * @param name[in] Operation measured, a static string
+ * @param value Cost of one operation, in RART_BENCH_UNIT unless unit says otherwise
+ * @param unit[in] Unit of the value, NULL for RART_BENCH_UNIT
+ */
+void rart_bench_report(const char *name, uint64_t value, const char *unit);
+
+/**
+ * @brief Format the recorded results in the format of scripts/bench_compare.py and clear
+ * them
+ *
+ * @param buffer[out] Buffer of the JSON text
+ * @param size Size of the buffer
+ * @param board[in] Board written with the results
+ * @return size_t Length of the JSON text, 0 if there is no result or it does not fit.
+ */
+size_t rart_bench_json(char *buffer, size_t size, const char *board);
+
+/**
+ * @brief Emit the recorded results in the format of scripts/bench_compare.py. The host
+ * runner writes them to the file given with --bench. Zephyr prints them on the console
+ * between RART-BENCH-BEGIN and RART-BENCH-END lines.
+ */
+void rart_bench_flush(void);
+
+/**
+ * @brief Measure the cost of a statement, repeated to average out the timer resolution
+ *
+ * @param name Operation measured, reported with rart_bench_report
+ * @param iterations Number of repetitions
+ * @param statement Statement measured
+ */
+#define RART_BENCH(name, iterations, statement)                                          \
+    do {                                                                                 \
+        uint64_t rart_bench_start = rart_bench_now();                                    \
+        for (uint32_t rart_bench_i = 0; rart_bench_i < (iterations); ++rart_bench_i) {   \
+            statement;                                                                   \
+        }                                                                                \
+        rart_bench_report(name, (rart_bench_now() - rart_bench_start) / (iterations),    \
+                          NULL);                                                         \
+    } while (0)
+
+#endif /* RART_TEST_H */
@@ -0,0 +1,236 @@
+/**
+ * @file bench_rart.c
+ * @brief Micro-benchmarks of the backend ABI, reported with rart_bench_report
+ * @version 0.1
+ */
+#include <stdatomic.h>
+
+#include "rart-test.h"
+
+/**
+ * @brief Repetitions of each measured operation
+ */
+#define BENCH_ITERATIONS 10000
+
+/**
+ * @brief Repetitions of the operations that wait for another thread or a timer
+ */
+#define BENCH_LATENCY_ITERATIONS 100
+
+/**
+ * @brief Threads locking the mutex of the contended benchmark
+ */
+#define BENCH_CONTENDERS 2
+
+/**
+ * @brief Lock/unlock pairs of each contender
+ */
+#define BENCH_CONTENDED_ITERATIONS 1000
+
+/**
+ * @brief Periods of the drift benchmark
+ */
+#define BENCH_DRIFT_PERIODS 10000
+
+/**
+ * @brief Period of the drift benchmark, in milliseconds
+ */
+#define BENCH_DRIFT_PERIOD_MS 1
+
+/**
+ * @brief Lateness allowed to the last period of the drift benchmark, in periods. Absolute
+ * deadlines only pay the wake-up latency of the last period, a re-armed relative timer
+ * accumulates the latency of every period and ends far beyond it.
+ */
+#define BENCH_DRIFT_TOLERANCE_PERIODS 10
+
+/**
+ * @brief Expirations of the periodic timer of the drift benchmark
+ */
+typedef struct {
+    atomic_uint count; /**< Expirations so far, the last one published after last_us */
+    uint64_t last_us;  /**< rart_test_now_us at expiration BENCH_DRIFT_PERIODS */
+} bench_drift_t;
+
+/**
+ * @brief Time a callback ran, published with a flag so 32 bit targets need no 64 bit
+ * atomics
+ */
+typedef struct {
+    atomic_uint called; /**< Set after stamp is written */
+    uint64_t stamp;     /**< rart_bench_now in the callback */
+} bench_stamp_t;
+
+/**
+ * @brief Send and receive items of a size through a fresh message queue
+ *
+ * @param name[in] Operation reported
+ * @param size Item size, in bytes, up to 16
+ */
+static void bench_msgq(const char *name, size_t size);
+
+/**
+ * @brief Lock and unlock the shared mutex, yielding while it is held so the other
+ * contenders block on it
+ *
+ * @param arg Mutex
+ */
+static void contender(void *arg);
+
+/**
+ * @brief Timer callback recording the counter when it runs
+ *
+ * @param state[in] bench_stamp_t
+ */
+static void stamp_callback(const void *state);
+
+/**
+ * @brief Periodic timer callback counting the expirations of the drift benchmark
+ *
+ * @param state[in] bench_drift_t
+ */
+static void drift_callback(const void *state);
+
+RART_TEST_SUITE(rart_bench, rtos_timer_init);
+
+RART_TEST(rart_bench, mutex_uncontended) {
+    void *mutex = rtos_mutex_new();
+
+    RART_ASSERT_NOT_NULL(mutex);
+
+    RART_BENCH("mutex_lock_unlock_uncontended", BENCH_ITERATIONS, {
+        rtos_mutex_lock(mutex, 0);
+        rtos_mutex_unlock(mutex);
+    });
+
+    rtos_mutex_del(mutex);
+}
+
+RART_TEST(rart_bench, mutex_contended) {
+    rart_test_thread_t threads[BENCH_CONTENDERS];
+    void *mutex = rtos_mutex_new();
+
+    RART_ASSERT_NOT_NULL(mutex);
+
+    uint64_t start = rart_bench_now();
+    for (int i = 0; i < BENCH_CONTENDERS; ++i) {
+        rart_test_thread_start(&threads[i], contender, mutex);
+    }
+    for (int i = 0; i < BENCH_CONTENDERS; ++i) {
+        rart_test_thread_join(&threads[i]);
+    }
+    uint64_t elapsed = rart_bench_now() - start;
+
+    rart_bench_report("mutex_lock_unlock_contended",
+                      elapsed / (BENCH_CONTENDERS * BENCH_CONTENDED_ITERATIONS), NULL);
+
+    rtos_mutex_del(mutex);
+}
+
+/* A single call, since every call takes a queue of the pool for good */
+RART_TEST(rart_bench, msgq_new_first_call) {
+    uint64_t start = rart_bench_now();
+    void *msgq     = rtos_msgq_new(sizeof(uint32_t));
+    uint64_t end   = rart_bench_now();
+
+    RART_ASSERT_NOT_NULL(msgq);
+
+    rart_bench_report("msgq_new_first_call", end - start, NULL);
+}
+
+RART_TEST(rart_bench, msgq_send_recv) {
+    bench_msgq("msgq_send_recv_4", 4);
+    bench_msgq("msgq_send_recv_8", 8);
+    bench_msgq("msgq_send_recv_16", 16);
+}
+
+RART_TEST(rart_bench, timer_arm_to_callback) {
+    static bench_stamp_t stamp;
+    uint64_t total = 0;
+
+    for (int i = 0; i < BENCH_LATENCY_ITERATIONS; ++i) {
+        atomic_store(&stamp.called, 0);
+
+        uint64_t start = rart_bench_now();
+        rtos_timer_reschedule(stamp_callback, &stamp, 0);
+
+        uint64_t deadline = rart_test_now_us() + 100000;
+        while (atomic_load(&stamp.called) == 0) {
+            RART_ASSERT(rart_test_now_us() < deadline, "Timer did not expire");
+            rart_test_sleep(1);
+        }
+
+        total += stamp.stamp - start;
+    }
+
+    rart_bench_report("timer_arm_to_callback", total / BENCH_LATENCY_ITERATIONS, NULL);
+}
+
+/* Lateness of the last of 10000 periods, which grows with every period on a re-armed
+ * relative timer and stays within a tick with absolute deadlines */
+RART_TEST(rart_bench, timer_periodic_drift) {
+    static bench_drift_t drift;
+
+    atomic_store(&drift.count, 0);
+
+    uint64_t start = rart_test_now_us();
+    void *timer    = rtos_timer_periodic_start(drift_callback, &drift,
+                                               BENCH_DRIFT_PERIOD_MS, RART_TIMER_MISSED_BURST);
+
+    RART_ASSERT_NOT_NULL(timer);
+
+    uint64_t expected = (uint64_t) BENCH_DRIFT_PERIODS * BENCH_DRIFT_PERIOD_MS * 1000;
+    uint64_t deadline = start + expected + 1000000;
+    while (atomic_load(&drift.count) < BENCH_DRIFT_PERIODS) {
+        RART_ASSERT(rart_test_now_us() < deadline, "Periods missing");
+        rart_test_sleep(10);
+    }
+    rtos_timer_periodic_stop(timer);
+
+    uint64_t elapsed = drift.last_us - start;
+    uint64_t late    = (elapsed > expected) ? elapsed - expected : 0;
+
+    rart_bench_report("timer_periodic_drift_10000", late, "us");
+    RART_ASSERT(late < BENCH_DRIFT_TOLERANCE_PERIODS * BENCH_DRIFT_PERIOD_MS * 1000,
+                "Last period %llu us late, the periods drift", (unsigned long long) late);
+}
+
+RART_TEST(rart_bench, heap_alloc_free) {
+    RART_BENCH("heap_alloc_free_64", BENCH_ITERATIONS, heap_free(heap_alloc(8, 64)));
+}
+
+static void bench_msgq(const char *name, size_t size) {
+    uint8_t item[16] = {0};
+    void *msgq       = rtos_msgq_new(size);
+
+    RART_ASSERT_NOT_NULL(msgq);
+
+    RART_BENCH(name, BENCH_ITERATIONS, {
+        rtos_msgq_send(msgq, item, 0);
+        rtos_msgq_recv(msgq, item, 0);
+    });
+}
+
+static void contender(void *arg) {
+    for (int i = 0; i < BENCH_CONTENDED_ITERATIONS; ++i) {
+        rtos_mutex_lock(arg, 1000);
+        rart_test_yield();
+        rtos_mutex_unlock(arg);
+    }
+}
+
+static void stamp_callback(const void *state) {
+    bench_stamp_t *stamp = (bench_stamp_t *) state;
+
+    stamp->stamp = rart_bench_now();
+    atomic_store(&stamp->called, 1);
+}
+
+static void drift_callback(const void *state) {
+    bench_drift_t *drift = (bench_drift_t *) state;
+
+    if (atomic_load(&drift->count) + 1 == BENCH_DRIFT_PERIODS) {
+        drift->last_us = rart_test_now_us();
+    }
+    atomic_fetch_add(&drift->count, 1);
+}
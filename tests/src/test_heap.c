@@ -0,0 +1,53 @@
+/**
+ * @file test_heap.c
+ * @brief Conformance of the heap ABI: alignment, independent chunks and reuse
+ * @version 0.1
+ */
+#include <string.h>
+
+#include "rart-test.h"
+
+RART_TEST_SUITE(rart_heap, NULL);
+
+RART_TEST(rart_heap, aligned) {
+    static const size_t aligns[] = {1, 2, 4, 8, 16, 32, 64};
+
+    for (size_t i = 0; i < sizeof(aligns) / sizeof(aligns[0]); ++i) {
+        const void *mem = heap_alloc(aligns[i], 24);
+
+        RART_ASSERT_NOT_NULL(mem);
+        RART_ASSERT_EQ((uintptr_t) mem % aligns[i], 0);
+        heap_free(mem);
+    }
+}
+
+RART_TEST(rart_heap, independent_chunks) {
+    uint8_t *chunks[8];
+
+    for (int i = 0; i < 8; ++i) {
+        chunks[i] = (uint8_t *) heap_alloc(sizeof(void *), 32);
+        RART_ASSERT_NOT_NULL(chunks[i]);
+        memset(chunks[i], i, 32);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 32; ++j) {
+            RART_ASSERT_EQ(chunks[i][j], i);
+        }
+        heap_free(chunks[i]);
+    }
+}
+
+RART_TEST(rart_heap, reused_after_free) {
+    /* A leak would exhaust the heap, which never returns NULL but stops the system */
+    for (int i = 0; i < 10000; ++i) {
+        const void *mem = heap_alloc(8, 64);
+
+        RART_ASSERT_NOT_NULL(mem);
+        heap_free(mem);
+    }
+}
+
+RART_TEST(rart_heap, free_null) {
+    heap_free(NULL);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file test_msgq.c
+ * @brief Conformance of the message queue ABI: FIFO order, capacity and timeouts
+ * @version 0.1
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "rart-defines.h"
+#include "rart-test.h"
+
+/**
+ * @brief Queue and results shared with a helper thread
+ */
+typedef struct {
+    void *msgq;       /**< Queue under test */
+    uint32_t delay;   /**< Delay before the operation of the helper thread, in ms */
+    uint32_t item;    /**< Item sent or received by the helper thread */
+    int32_t ret;      /**< Result of the operation of the helper thread */
+} msgq_ctx_t;
+
+/**
+ * @brief Sleep for the context delay, then send the context item
+ *
+ * @param arg[in,out] msgq_ctx_t
+ */
+static void send_thread(void *arg);
+
+/**
+ * @brief Sleep for the context delay, then receive an item in the context
+ *
+ * @param arg[in,out] msgq_ctx_t
+ */
+static void recv_thread(void *arg);
+
+RART_TEST_SUITE(rart_msgq, NULL);
+
+RART_TEST(rart_msgq, fifo_order) {
+    void *msgq = rtos_msgq_new(sizeof(uint32_t));
+
+    RART_ASSERT_NOT_NULL(msgq);
+
+    for (uint32_t round = 0; round < 3; ++round) {
+        for (uint32_t i = 0; i < NUM_OF_MSG_ITENS; ++i) {
+            uint32_t item = round * 100 + i;
+            RART_ASSERT_EQ(rtos_msgq_send(msgq, &item, 0), 0);
+        }
+
+        for (uint32_t i = 0; i < NUM_OF_MSG_ITENS; ++i) {
+            uint32_t item = 0;
+            RART_ASSERT_EQ(rtos_msgq_recv(msgq, &item, 0), 0);
+            RART_ASSERT_EQ(item, round * 100 + i);
+        }
+    }
+}
+
+RART_TEST(rart_msgq, item_size_kept) {
+    uint8_t item[MSG_ITEM_SIZE];
+    uint8_t out[MSG_ITEM_SIZE + 1];
+    void *msgq = rtos_msgq_new(sizeof(item));
+
+    RART_ASSERT_NOT_NULL(msgq);
+
+    for (size_t i = 0; i < sizeof(item); ++i) {
+        item[i] = 0xA0 + i;
+    }
+    memset(out, 0x5A, sizeof(out));
+
+    RART_ASSERT_EQ(rtos_msgq_send(msgq, item, 0), 0);
+    RART_ASSERT_EQ(rtos_msgq_recv(msgq, out, 0), 0);
+    RART_ASSERT(memcmp(item, out, sizeof(item)) == 0, "Item changed in the queue");
+    RART_ASSERT_EQ(out[sizeof(item)], 0x5A);
+}
+
+RART_TEST(rart_msgq, item_too_big) {
+    RART_ASSERT_NULL(rtos_msgq_new(MSG_ITEM_SIZE + 1));
+}
+
+RART_TEST(rart_msgq, full_and_empty) {
+    void *msgq    = rtos_msgq_new(sizeof(uint32_t));
+    uint32_t item = 0;
+
+    RART_ASSERT_NOT_NULL(msgq);
+    RART_ASSERT_EQ(rtos_msgq_recv(msgq, &item, 0), -ENOMSG);
+
+    for (uint32_t i = 0; i < NUM_OF_MSG_ITENS; ++i) {
+        RART_ASSERT_EQ(rtos_msgq_send(msgq, &i, 0), 0);
+    }
+    RART_ASSERT_EQ(rtos_msgq_send(msgq, &item, 0), -ENOMSG);
+
+    uint64_t start = rart_test_now_us();
+    RART_ASSERT_EQ(rtos_msgq_send(msgq, &item, 50), -EAGAIN);
+    uint64_t elapsed = rart_test_now_us() - start;
+    RART_ASSERT(elapsed >= 45000, "Send timed out after %u us, expected 50 ms",
+                (unsigned) elapsed);
+
+    for (uint32_t i = 0; i < NUM_OF_MSG_ITENS; ++i) {
+        RART_ASSERT_EQ(rtos_msgq_recv(msgq, &item, 0), 0);
+    }
+
+    start = rart_test_now_us();
+    RART_ASSERT_EQ(rtos_msgq_recv(msgq, &item, 50), -EAGAIN);
+    elapsed = rart_test_now_us() - start;
+    RART_ASSERT(elapsed >= 45000, "Receive timed out after %u us, expected 50 ms",
+                (unsigned) elapsed);
+}
+
+RART_TEST(rart_msgq, recv_woken_by_send) {
+    msgq_ctx_t ctx = {.msgq = rtos_msgq_new(sizeof(uint32_t)), .delay = 20, .item = 0xC0FFEE};
+    rart_test_thread_t thread;
+    uint32_t item = 0;
+
+    RART_ASSERT_NOT_NULL(ctx.msgq);
+
+    rart_test_thread_start(&thread, send_thread, &ctx);
+    RART_ASSERT_EQ(rtos_msgq_recv(ctx.msgq, &item, 1000), 0);
+    rart_test_thread_join(&thread);
+
+    RART_ASSERT_EQ(ctx.ret, 0);
+    RART_ASSERT_EQ(item, 0xC0FFEE);
+}
+
+RART_TEST(rart_msgq, send_woken_by_recv) {
+    msgq_ctx_t ctx = {.msgq = rtos_msgq_new(sizeof(uint32_t)), .delay = 20};
+    rart_test_thread_t thread;
+
+    RART_ASSERT_NOT_NULL(ctx.msgq);
+
+    for (uint32_t i = 0; i < NUM_OF_MSG_ITENS; ++i) {
+        RART_ASSERT_EQ(rtos_msgq_send(ctx.msgq, &i, 0), 0);
+    }
+
+    uint32_t last = NUM_OF_MSG_ITENS;
+
+    rart_test_thread_start(&thread, recv_thread, &ctx);
+    RART_ASSERT_EQ(rtos_msgq_send(ctx.msgq, &last, 1000), 0);
+    rart_test_thread_join(&thread);
+
+    RART_ASSERT_EQ(ctx.ret, 0);
+    RART_ASSERT_EQ(ctx.item, 0);
+
+    for (uint32_t i = 1; i <= NUM_OF_MSG_ITENS; ++i) {
+        uint32_t item = 0;
+        RART_ASSERT_EQ(rtos_msgq_recv(ctx.msgq, &item, 0), 0);
+        RART_ASSERT_EQ(item, i);
+    }
+}
+
+RART_TEST(rart_msgq, independent_queues) {
+    void *first   = rtos_msgq_new(sizeof(uint32_t));
+    void *second  = rtos_msgq_new(sizeof(uint16_t));
+    uint32_t item = 1;
+    uint16_t half = 2;
+
+    RART_ASSERT_NOT_NULL(first);
+    RART_ASSERT_NOT_NULL(second);
+    RART_ASSERT(first != second, "The same queue was handed out twice");
+
+    RART_ASSERT_EQ(rtos_msgq_send(first, &item, 0), 0);
+    RART_ASSERT_EQ(rtos_msgq_send(second, &half, 0), 0);
+
+    item = 0;
+    half = 0;
+    RART_ASSERT_EQ(rtos_msgq_recv(second, &half, 0), 0);
+    RART_ASSERT_EQ(rtos_msgq_recv(second, &half, 0), -ENOMSG);
+    RART_ASSERT_EQ(rtos_msgq_recv(first, &item, 0), 0);
+    RART_ASSERT_EQ(item, 1);
+    RART_ASSERT_EQ(half, 2);
+}
+
+static void send_thread(void *arg) {
+    msgq_ctx_t *ctx = arg;
+
+    rart_test_sleep(ctx->delay);
+    ctx->ret = rtos_msgq_send(ctx->msgq, &ctx->item, 1000);
+}
+
+static void recv_thread(void *arg) {
+    msgq_ctx_t *ctx = arg;
+
+    rart_test_sleep(ctx->delay);
+    ctx->ret = rtos_msgq_recv(ctx->msgq, &ctx->item, 1000);
+}
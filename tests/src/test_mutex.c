@@ -0,0 +1,192 @@
+/**
+ * @file test_mutex.c
+ * @brief Conformance of the mutex ABI: lock, timeouts, recursion and ownership
+ * @version 0.1
+ */
+#include <errno.h>
+
+#include "rart-test.h"
+
+/**
+ * @brief Mutex and results shared with a helper thread
+ */
+typedef struct {
+    void *mutex;      /**< Mutex under test */
+    uint32_t timeout; /**< Timeout of the lock of the helper thread */
+    uint32_t hold;    /**< Time the helper thread holds the mutex, in milliseconds */
+    int32_t ret;      /**< Result of the operation of the helper thread */
+    uint64_t elapsed; /**< Duration of the operation of the helper thread, in microseconds */
+} mutex_ctx_t;
+
+/**
+ * @brief Lock the mutex with the context timeout and record the result
+ *
+ * @param arg[in,out] mutex_ctx_t
+ */
+static void lock_thread(void *arg);
+
+/**
+ * @brief Lock the mutex, hold it for the context time and unlock it
+ *
+ * @param arg[in,out] mutex_ctx_t
+ */
+static void hold_thread(void *arg);
+
+/**
+ * @brief Unlock the mutex, which the helper thread does not hold
+ *
+ * @param arg[in,out] mutex_ctx_t
+ */
+static void unlock_thread(void *arg);
+
+RART_TEST_SUITE(rart_mutex, NULL);
+
+RART_TEST(rart_mutex, lock_unlock) {
+    void *mutex = rtos_mutex_new();
+
+    RART_ASSERT_NOT_NULL(mutex);
+    RART_ASSERT_EQ(rtos_mutex_lock(mutex, 0), 0);
+    RART_ASSERT_EQ(rtos_mutex_unlock(mutex), 0);
+    RART_ASSERT_EQ(rtos_mutex_lock(mutex, 100), 0);
+    RART_ASSERT_EQ(rtos_mutex_unlock(mutex), 0);
+
+    rtos_mutex_del(mutex);
+}
+
+RART_TEST(rart_mutex, busy_without_timeout) {
+    mutex_ctx_t ctx = {.mutex = rtos_mutex_new(), .timeout = 0};
+    rart_test_thread_t thread;
+
+    RART_ASSERT_NOT_NULL(ctx.mutex);
+    RART_ASSERT_EQ(rtos_mutex_lock(ctx.mutex, 0), 0);
+
+    rart_test_thread_start(&thread, lock_thread, &ctx);
+    rart_test_thread_join(&thread);
+
+    RART_ASSERT_EQ(ctx.ret, -EBUSY);
+    RART_ASSERT(ctx.elapsed < 10000, "Lock without timeout blocked %u us",
+                (unsigned) ctx.elapsed);
+
+    RART_ASSERT_EQ(rtos_mutex_unlock(ctx.mutex), 0);
+    rtos_mutex_del(ctx.mutex);
+}
+
+RART_TEST(rart_mutex, timeout_expires) {
+    mutex_ctx_t ctx = {.mutex = rtos_mutex_new(), .timeout = 50};
+    rart_test_thread_t thread;
+
+    RART_ASSERT_NOT_NULL(ctx.mutex);
+    RART_ASSERT_EQ(rtos_mutex_lock(ctx.mutex, 0), 0);
+
+    rart_test_thread_start(&thread, lock_thread, &ctx);
+    rart_test_thread_join(&thread);
+
+    RART_ASSERT_EQ(ctx.ret, -EAGAIN);
+    RART_ASSERT(ctx.elapsed >= 45000, "Lock timed out after %u us, expected 50 ms",
+                (unsigned) ctx.elapsed);
+
+    RART_ASSERT_EQ(rtos_mutex_unlock(ctx.mutex), 0);
+    rtos_mutex_del(ctx.mutex);
+}
+
+RART_TEST(rart_mutex, acquired_when_released) {
+    mutex_ctx_t ctx = {.mutex = rtos_mutex_new(), .hold = 30};
+    rart_test_thread_t thread;
+
+    RART_ASSERT_NOT_NULL(ctx.mutex);
+
+    rart_test_thread_start(&thread, hold_thread, &ctx);
+    rart_test_sleep(10);
+
+    uint64_t start = rart_test_now_us();
+    RART_ASSERT_EQ(rtos_mutex_lock(ctx.mutex, 1000), 0);
+    uint64_t elapsed = rart_test_now_us() - start;
+
+    RART_ASSERT(elapsed < 500000, "Lock took %u us after the release", (unsigned) elapsed);
+    RART_ASSERT_EQ(rtos_mutex_unlock(ctx.mutex), 0);
+
+    rart_test_thread_join(&thread);
+    RART_ASSERT_EQ(ctx.ret, 0);
+    rtos_mutex_del(ctx.mutex);
+}
+
+RART_TEST(rart_mutex, recursive) {
+    mutex_ctx_t ctx = {.mutex = rtos_mutex_new(), .timeout = 0};
+    rart_test_thread_t thread;
+
+    RART_ASSERT_NOT_NULL(ctx.mutex);
+    RART_ASSERT_EQ(rtos_mutex_lock(ctx.mutex, 0), 0);
+    RART_ASSERT_EQ(rtos_mutex_lock(ctx.mutex, 0), 0);
+    RART_ASSERT_EQ(rtos_mutex_unlock(ctx.mutex), 0);
+
+    /* Still held once */
+    rart_test_thread_start(&thread, lock_thread, &ctx);
+    rart_test_thread_join(&thread);
+    RART_ASSERT_EQ(ctx.ret, -EBUSY);
+
+    RART_ASSERT_EQ(rtos_mutex_unlock(ctx.mutex), 0);
+
+    rart_test_thread_start(&thread, lock_thread, &ctx);
+    rart_test_thread_join(&thread);
+    RART_ASSERT_EQ(ctx.ret, 0);
+
+    rtos_mutex_del(ctx.mutex);
+}
+
+RART_TEST(rart_mutex, unlock_by_other_task) {
+    mutex_ctx_t ctx = {.mutex = rtos_mutex_new()};
+    rart_test_thread_t thread;
+
+    RART_ASSERT_NOT_NULL(ctx.mutex);
+    RART_ASSERT_EQ(rtos_mutex_lock(ctx.mutex, 0), 0);
+
+    rart_test_thread_start(&thread, unlock_thread, &ctx);
+    rart_test_thread_join(&thread);
+
+    RART_ASSERT_EQ(ctx.ret, -EPERM);
+    RART_ASSERT_EQ(rtos_mutex_unlock(ctx.mutex), 0);
+    rtos_mutex_del(ctx.mutex);
+}
+
+RART_TEST(rart_mutex, reused_after_del) {
+    void *mutex = rtos_mutex_new();
+
+    RART_ASSERT_NOT_NULL(mutex);
+    rtos_mutex_del(mutex);
+
+    for (int i = 0; i < 1000; ++i) {
+        mutex = rtos_mutex_new();
+        RART_ASSERT_NOT_NULL(mutex);
+        RART_ASSERT_EQ(rtos_mutex_lock(mutex, 0), 0);
+        RART_ASSERT_EQ(rtos_mutex_unlock(mutex), 0);
+        rtos_mutex_del(mutex);
+    }
+}
+
+static void lock_thread(void *arg) {
+    mutex_ctx_t *ctx = arg;
+    uint64_t start   = rart_test_now_us();
+
+    ctx->ret     = rtos_mutex_lock(ctx->mutex, ctx->timeout);
+    ctx->elapsed = rart_test_now_us() - start;
+
+    if (ctx->ret == 0) {
+        rtos_mutex_unlock(ctx->mutex);
+    }
+}
+
+static void hold_thread(void *arg) {
+    mutex_ctx_t *ctx = arg;
+
+    ctx->ret = rtos_mutex_lock(ctx->mutex, 0);
+    rart_test_sleep(ctx->hold);
+    if (ctx->ret == 0) {
+        ctx->ret = rtos_mutex_unlock(ctx->mutex);
+    }
+}
+
+static void unlock_thread(void *arg) {
+    mutex_ctx_t *ctx = arg;
+
+    ctx->ret = rtos_mutex_unlock(ctx->mutex);
+}
@@ -0,0 +1,156 @@
+/**
+ * @file test_pool.c
+ * @brief Conformance of the pools at their full size, also built with more than 254
+ * objects per pool so the wide pool indices are covered
+ * @version 0.1
+ */
+#include <errno.h>
+
+#include "rart-defines.h"
+#include "rart-test.h"
+
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+/**
+ * @brief Timers taken from the heap in each round of the overflow test
+ */
+#define OVERFLOW_TIMERS 2
+
+/**
+ * @brief Rounds of the overflow test
+ */
+#define OVERFLOW_ROUNDS 20
+
+/**
+ * @brief Timer callback of the pool tests, never expected to run
+ *
+ * @param state[in] Unused
+ */
+static void idle_callback(const void *state);
+#endif
+
+RART_TEST_SUITE(rart_pool, rtos_timer_init);
+
+RART_TEST(rart_pool, every_mutex) {
+    static void *mutexes[NUM_OF_MUTEXES];
+
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        mutexes[i] = rtos_mutex_new();
+        RART_ASSERT_NOT_NULL(mutexes[i]);
+        RART_ASSERT_EQ(rtos_mutex_lock(mutexes[i], 0), 0);
+    }
+
+#if !defined(CONFIG_RART_POOL_OVERFLOW)
+    RART_ASSERT_NULL(rtos_mutex_new());
+#endif
+
+    /* Every mutex is still held, so none was handed out twice */
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        RART_ASSERT_EQ(rtos_mutex_unlock(mutexes[i]), 0);
+        RART_ASSERT_EQ(rtos_mutex_unlock(mutexes[i]), -EPERM);
+    }
+
+    /* The last slot released is the one taken again */
+    rtos_mutex_del(mutexes[NUM_OF_MUTEXES - 1]);
+    mutexes[NUM_OF_MUTEXES - 1] = rtos_mutex_new();
+    RART_ASSERT_NOT_NULL(mutexes[NUM_OF_MUTEXES - 1]);
+
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        rtos_mutex_del(mutexes[i]);
+    }
+}
+
+RART_TEST(rart_pool, mutex_deleted_twice) {
+    rart_pool_stats_t stats;
+    void *mutex = rtos_mutex_new();
+
+    RART_ASSERT_NOT_NULL(mutex);
+    rtos_mutex_del(mutex);
+    rtos_mutex_del(mutex);
+
+    if (rtos_pool_stats_get(RART_POOL_MUTEX, &stats) == 0) {
+        RART_ASSERT_EQ(stats.in_use, 0);
+    }
+
+    /* The pool still hands out each mutex once */
+    static void *mutexes[NUM_OF_MUTEXES];
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        mutexes[i] = rtos_mutex_new();
+        RART_ASSERT_NOT_NULL(mutexes[i]);
+        RART_ASSERT_EQ(rtos_mutex_lock(mutexes[i], 0), 0);
+    }
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        RART_ASSERT_EQ(rtos_mutex_unlock(mutexes[i]), 0);
+        rtos_mutex_del(mutexes[i]);
+    }
+}
+
+RART_TEST(rart_pool, foreign_pointer_ignored) {
+    static uint64_t foreign[32];
+    void *mutex = rtos_mutex_new();
+
+    RART_ASSERT_NOT_NULL(mutex);
+
+    /* Never a mutex or timer of the backend, so it is neither released nor stopped */
+    rtos_mutex_del(foreign);
+    rtos_timer_periodic_stop(foreign);
+    RART_ASSERT_EQ(rtos_timer_periodic_missed(foreign), 0);
+
+    RART_ASSERT_EQ(rtos_mutex_lock(mutex, 0), 0);
+    RART_ASSERT_EQ(rtos_mutex_unlock(mutex), 0);
+    rtos_mutex_del(mutex);
+}
+
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+RART_TEST(rart_pool, overflow_timers_recycled) {
+    static void *timers[NUM_OF_TIMERS + OVERFLOW_TIMERS];
+    rart_pool_stats_t before;
+    rart_pool_stats_t after;
+
+    RART_ASSERT_EQ(rtos_pool_stats_get(RART_POOL_TIMER, &before), 0);
+
+    /* Heap timers are stopped, kept as spares and given back to the heap */
+    for (int round = 0; round < OVERFLOW_ROUNDS; ++round) {
+        for (int i = 0; i < NUM_OF_TIMERS + OVERFLOW_TIMERS; ++i) {
+            timers[i] = rtos_timer_periodic_start(idle_callback, NULL, 1000,
+                                                  RART_TIMER_MISSED_SKIP);
+            RART_ASSERT_NOT_NULL(timers[i]);
+        }
+        for (int i = 0; i < NUM_OF_TIMERS + OVERFLOW_TIMERS; ++i) {
+            RART_ASSERT_EQ(rtos_timer_periodic_missed(timers[i]), 0);
+            rtos_timer_periodic_stop(timers[i]);
+        }
+        rart_test_sleep((round % 2 == 0) ? 1 : 30);
+    }
+
+    RART_ASSERT_EQ(rtos_pool_stats_get(RART_POOL_TIMER, &after), 0);
+    RART_ASSERT_EQ(after.in_use, 0);
+    RART_ASSERT_EQ(after.overflowed - before.overflowed, OVERFLOW_ROUNDS * OVERFLOW_TIMERS);
+}
+#endif
+
+RART_TEST(rart_pool, every_msgq) {
+    static void *queues[NUM_OF_MSGQ];
+
+    for (uint32_t i = 0; i < NUM_OF_MSGQ; ++i) {
+        queues[i] = rtos_msgq_new(sizeof(uint32_t));
+        RART_ASSERT_NOT_NULL(queues[i]);
+        RART_ASSERT_EQ(rtos_msgq_send(queues[i], &i, 0), 0);
+    }
+
+    RART_ASSERT_NULL(rtos_msgq_new(sizeof(uint32_t)));
+
+    /* Each queue holds only its own item */
+    for (uint32_t i = 0; i < NUM_OF_MSGQ; ++i) {
+        uint32_t item = ~i;
+
+        RART_ASSERT_EQ(rtos_msgq_recv(queues[i], &item, 0), 0);
+        RART_ASSERT_EQ(item, i);
+        RART_ASSERT_EQ(rtos_msgq_recv(queues[i], &item, 0), -ENOMSG);
+    }
+}
+
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+static void idle_callback(const void *state) {
+    (void) state;
+}
+#endif
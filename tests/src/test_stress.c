@@ -0,0 +1,270 @@
+/**
+ * @file test_stress.c
+ * @brief Stress of the backend ABI from concurrent tasks: producers, mutexes, pools and
+ * timers
+ * @version 0.1
+ */
+#include <errno.h>
+#include <stdatomic.h>
+
+#include "rart-defines.h"
+#include "rart-test.h"
+
+/**
+ * @brief Number of concurrent tasks of each test
+ */
+#define STRESS_TASKS 4
+
+/**
+ * @brief Items sent by each producer
+ */
+#define ITEMS_PER_PRODUCER 2000
+
+/**
+ * @brief Lock and unlock rounds of each task
+ */
+#define LOCKS_PER_TASK 20000
+
+/**
+ * @brief Mutexes taken and given back by each task of the pool churn
+ */
+#define CLAIMS_PER_TASK 5000
+
+/**
+ * @brief One-shot timers armed by each task
+ */
+#define TIMERS_PER_TASK 100
+
+/**
+ * @brief State shared by the tasks of a test
+ */
+typedef struct {
+    void *object;           /**< Queue or mutex shared by the tasks */
+    uint32_t id;            /**< Index of the task */
+    int32_t failures;       /**< Operations of the task that failed */
+    uint32_t counter;       /**< Counter protected by the mutex */
+    atomic_uint expired;    /**< Expirations of the timers of the task */
+} stress_ctx_t;
+
+/**
+ * @brief Send ITEMS_PER_PRODUCER items tagged with the producer index
+ *
+ * @param arg[in,out] stress_ctx_t of the producer
+ */
+static void producer_thread(void *arg);
+
+/**
+ * @brief Increment the shared counter LOCKS_PER_TASK times under the mutex
+ *
+ * @param arg[in,out] stress_ctx_t shared by the tasks
+ */
+static void counter_thread(void *arg);
+
+/**
+ * @brief Take, lock and give back CLAIMS_PER_TASK mutexes of the pool
+ *
+ * @param arg[in,out] stress_ctx_t of the task
+ */
+static void claim_thread(void *arg);
+
+/**
+ * @brief Arm TIMERS_PER_TASK one-shot timers, one after the other
+ *
+ * @param arg[in,out] stress_ctx_t of the task
+ */
+static void timer_thread(void *arg);
+
+/**
+ * @brief Timer callback counting the expirations of a task
+ *
+ * @param state[in] stress_ctx_t of the task
+ */
+static void expired_callback(const void *state);
+
+RART_TEST_SUITE(rart_stress, rtos_timer_init);
+
+RART_TEST(rart_stress, concurrent_producers) {
+    static stress_ctx_t producers[STRESS_TASKS];
+    rart_test_thread_t threads[STRESS_TASKS];
+    uint32_t next[STRESS_TASKS] = {0};
+    void *msgq                  = rtos_msgq_new(sizeof(uint32_t));
+
+    RART_ASSERT_NOT_NULL(msgq);
+
+    for (uint32_t i = 0; i < STRESS_TASKS; ++i) {
+        producers[i].object = msgq;
+        producers[i].id     = i;
+        rart_test_thread_start(&threads[i], producer_thread, &producers[i]);
+    }
+
+    for (uint32_t n = 0; n < STRESS_TASKS * ITEMS_PER_PRODUCER; ++n) {
+        uint32_t item = 0;
+
+        RART_ASSERT_EQ(rtos_msgq_recv(msgq, &item, 1000), 0);
+
+        /* Each producer is in FIFO order, whatever the interleaving */
+        uint32_t producer = item >> 24;
+        RART_ASSERT(producer < STRESS_TASKS, "Corrupted item 0x%08x", (unsigned) item);
+        RART_ASSERT_EQ(item & 0xFFFFFF, next[producer]);
+        next[producer]++;
+    }
+
+    for (uint32_t i = 0; i < STRESS_TASKS; ++i) {
+        rart_test_thread_join(&threads[i]);
+        RART_ASSERT_EQ(producers[i].failures, 0);
+    }
+
+    uint32_t item = 0;
+    RART_ASSERT_EQ(rtos_msgq_recv(msgq, &item, 0), -ENOMSG);
+}
+
+RART_TEST(rart_stress, mutex_counter) {
+    static stress_ctx_t ctx;
+    rart_test_thread_t threads[STRESS_TASKS];
+
+    ctx.object = rtos_mutex_new();
+    RART_ASSERT_NOT_NULL(ctx.object);
+
+    for (int i = 0; i < STRESS_TASKS; ++i) {
+        rart_test_thread_start(&threads[i], counter_thread, &ctx);
+    }
+    for (int i = 0; i < STRESS_TASKS; ++i) {
+        rart_test_thread_join(&threads[i]);
+    }
+
+    RART_ASSERT_EQ(ctx.failures, 0);
+    RART_ASSERT_EQ(ctx.counter, STRESS_TASKS * LOCKS_PER_TASK);
+    rtos_mutex_del(ctx.object);
+}
+
+/* On SMP the tasks claim slots of the same bitmap words from several cores at once */
+RART_TEST(rart_stress, mutex_pool_churn) {
+    static stress_ctx_t tasks[STRESS_TASKS];
+    rart_test_thread_t threads[STRESS_TASKS];
+
+    for (uint32_t i = 0; i < STRESS_TASKS; ++i) {
+        tasks[i].id = i;
+        rart_test_thread_start(&threads[i], claim_thread, &tasks[i]);
+    }
+
+    for (uint32_t i = 0; i < STRESS_TASKS; ++i) {
+        rart_test_thread_join(&threads[i]);
+        RART_ASSERT_EQ(tasks[i].failures, 0);
+    }
+
+    /* Every mutex is back in the pool */
+    static void *mutexes[NUM_OF_MUTEXES];
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        mutexes[i] = rtos_mutex_new();
+        RART_ASSERT_NOT_NULL(mutexes[i]);
+    }
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        rtos_mutex_del(mutexes[i]);
+    }
+}
+
+RART_TEST(rart_stress, timer_churn) {
+    static stress_ctx_t tasks[STRESS_TASKS - 1];
+    static stress_ctx_t periodic;
+    rart_test_thread_t threads[STRESS_TASKS - 1];
+
+    for (uint32_t i = 0; i < STRESS_TASKS - 1; ++i) {
+        tasks[i].id = i;
+        rart_test_thread_start(&threads[i], timer_thread, &tasks[i]);
+    }
+
+    /* Periodic timers taken and given back while the one-shots churn */
+    for (int i = 0; i < 50; ++i) {
+        void *timer = rtos_timer_periodic_start(expired_callback, &periodic, 1,
+                                                RART_TIMER_MISSED_SKIP);
+
+        RART_ASSERT_NOT_NULL(timer);
+        rart_test_sleep(3);
+        rtos_timer_periodic_stop(timer);
+    }
+
+    for (uint32_t i = 0; i < STRESS_TASKS - 1; ++i) {
+        rart_test_thread_join(&threads[i]);
+        RART_ASSERT_EQ(tasks[i].failures, 0);
+    }
+
+    /* Late expirations would land here */
+    rart_test_sleep(20);
+    for (uint32_t i = 0; i < STRESS_TASKS - 1; ++i) {
+        RART_ASSERT_EQ(atomic_load(&tasks[i].expired), TIMERS_PER_TASK);
+    }
+    RART_ASSERT(atomic_load(&periodic.expired) > 0, "Periodic timers never expired");
+}
+
+static void producer_thread(void *arg) {
+    stress_ctx_t *ctx = arg;
+
+    for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+        uint32_t item = (ctx->id << 24) | i;
+
+        if (rtos_msgq_send(ctx->object, &item, 1000) != 0) {
+            ctx->failures++;
+        }
+    }
+}
+
+static void counter_thread(void *arg) {
+    stress_ctx_t *ctx = arg;
+    int32_t failures  = 0;
+
+    for (int i = 0; i < LOCKS_PER_TASK; ++i) {
+        if (rtos_mutex_lock(ctx->object, 1000) != 0) {
+            failures++;
+            continue;
+        }
+        ctx->counter++;
+        rtos_mutex_unlock(ctx->object);
+    }
+
+    if (failures != 0) {
+        rtos_mutex_lock(ctx->object, 1000);
+        ctx->failures += failures;
+        rtos_mutex_unlock(ctx->object);
+    }
+}
+
+static void claim_thread(void *arg) {
+    stress_ctx_t *ctx = arg;
+
+    for (uint32_t i = 0; i < CLAIMS_PER_TASK; ++i) {
+        void *mutex = rtos_mutex_new();
+
+        /* A slot handed out twice is held by the other task, the lock fails */
+        if (mutex == NULL || rtos_mutex_lock(mutex, 0) != 0) {
+            ctx->failures++;
+            continue;
+        }
+
+        rart_test_yield();
+        rtos_mutex_unlock(mutex);
+        rtos_mutex_del(mutex);
+    }
+}
+
+static void timer_thread(void *arg) {
+    stress_ctx_t *ctx = arg;
+
+    for (uint32_t i = 0; i < TIMERS_PER_TASK; ++i) {
+        rtos_timer_reschedule(expired_callback, ctx, (i + ctx->id) % 4);
+
+        uint64_t end = rart_test_now_us() + 1000000;
+        while (atomic_load(&ctx->expired) <= i) {
+            if (rart_test_now_us() > end) {
+                ctx->failures++;
+                return;
+            }
+            rart_test_sleep(1);
+        }
+    }
+}
+
+static void expired_callback(const void *state) {
+    stress_ctx_t *ctx = (stress_ctx_t *) state;
+
+    atomic_fetch_add(&ctx->expired, 1);
+}
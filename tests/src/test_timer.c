@@ -0,0 +1,220 @@
+/**
+ * @file test_timer.c
+ * @brief Conformance of the timer ABI: one-shot order, periodic timers and pool size
+ * @version 0.1
+ */
+#include <stdatomic.h>
+
+#include "rart-defines.h"
+#include "rart-test.h"
+
+/**
+ * @brief Maximum number of expirations recorded by a recorder
+ */
+#define RECORD_MAX 8
+
+/**
+ * @brief Expirations seen by the timer callbacks of a test
+ */
+typedef struct {
+    atomic_uint count;               /**< Number of expirations */
+    uint32_t order[RECORD_MAX];      /**< State of the first expirations */
+    uint64_t first_us;               /**< Time of the first expiration */
+    uint32_t stall_us;               /**< Time the first callback spins, in microseconds */
+} recorder_t;
+
+/**
+ * @brief Expiration state of a one-shot timer, recording its tag
+ */
+typedef struct {
+    recorder_t *recorder; /**< Recorder of the test */
+    uint32_t tag;         /**< Value recorded in the expiration order */
+} tagged_t;
+
+/**
+ * @brief Timer callback counting the expirations of a recorder
+ *
+ * @param state[in] recorder_t
+ */
+static void count_callback(const void *state);
+
+/**
+ * @brief Timer callback recording the tag of a one-shot timer
+ *
+ * @param state[in] tagged_t
+ */
+static void tag_callback(const void *state);
+
+/**
+ * @brief Wait until a recorder sees a number of expirations
+ *
+ * @param recorder[in] Recorder
+ * @param count Expected number of expirations
+ * @param timeout Maximum wait, in milliseconds
+ * @return bool True if the expirations arrived in time.
+ */
+static bool wait_count(recorder_t *recorder, uint32_t count, uint32_t timeout);
+
+RART_TEST_SUITE(rart_timer, rtos_timer_init);
+
+RART_TEST(rart_timer, oneshot_fires_once) {
+    static recorder_t recorder;
+    uint64_t start = rart_test_now_us();
+
+    rtos_timer_reschedule(count_callback, &recorder, 30);
+
+    rart_test_sleep(10);
+    RART_ASSERT_EQ(atomic_load(&recorder.count), 0);
+
+    RART_ASSERT(wait_count(&recorder, 1, 1000), "Timer did not expire");
+    uint64_t elapsed = recorder.first_us - start;
+    RART_ASSERT(elapsed >= 29000, "Timer expired after %u us, expected 30 ms",
+                (unsigned) elapsed);
+
+    rart_test_sleep(60);
+    RART_ASSERT_EQ(atomic_load(&recorder.count), 1);
+}
+
+RART_TEST(rart_timer, zero_timeout) {
+    static recorder_t recorder;
+
+    rtos_timer_reschedule(count_callback, &recorder, 0);
+
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Timer without timeout did not expire");
+}
+
+RART_TEST(rart_timer, oneshot_order) {
+    static recorder_t recorder;
+    static tagged_t tags[3] = {{&recorder, 3}, {&recorder, 1}, {&recorder, 2}};
+
+    rtos_timer_reschedule(tag_callback, &tags[0], 60);
+    rtos_timer_reschedule(tag_callback, &tags[1], 20);
+    rtos_timer_reschedule(tag_callback, &tags[2], 40);
+
+    RART_ASSERT(wait_count(&recorder, 3, 1000), "Timers did not expire");
+    RART_ASSERT_EQ(recorder.order[0], 1);
+    RART_ASSERT_EQ(recorder.order[1], 2);
+    RART_ASSERT_EQ(recorder.order[2], 3);
+}
+
+RART_TEST(rart_timer, periodic_invalid) {
+    static recorder_t recorder;
+
+    RART_ASSERT_NULL(rtos_timer_periodic_start(count_callback, &recorder, 0,
+                                               RART_TIMER_MISSED_BURST));
+}
+
+RART_TEST(rart_timer, periodic_stops) {
+    static recorder_t recorder;
+    void *timer = rtos_timer_periodic_start(count_callback, &recorder, 10,
+                                            RART_TIMER_MISSED_BURST);
+
+    RART_ASSERT_NOT_NULL(timer);
+    RART_ASSERT(wait_count(&recorder, 10, 1000), "Periodic timer did not expire 10 times");
+
+    uint64_t elapsed = rart_test_now_us() - recorder.first_us;
+    RART_ASSERT(elapsed >= 89000, "10 periods of 10 ms took %u us", (unsigned) elapsed);
+
+    rtos_timer_periodic_stop(timer);
+    uint32_t count = atomic_load(&recorder.count);
+
+    rart_test_sleep(50);
+    RART_ASSERT(atomic_load(&recorder.count) <= count + 1, "Timer expired after the stop");
+}
+
+RART_TEST(rart_timer, periodic_skip_missed) {
+    static recorder_t recorder = {.stall_us = 35000};
+    void *timer = rtos_timer_periodic_start(count_callback, &recorder, 10,
+                                            RART_TIMER_MISSED_SKIP);
+
+    RART_ASSERT_NOT_NULL(timer);
+    rart_test_sleep(205);
+
+    uint32_t missed = rtos_timer_periodic_missed(timer);
+    rtos_timer_periodic_stop(timer);
+    uint32_t count = atomic_load(&recorder.count);
+
+    /* The stall of the first call covers three periods, which are dropped */
+    RART_ASSERT(missed >= 2, "%u periods missed, expected at least 2", (unsigned) missed);
+    RART_ASSERT(count <= 18, "%u callbacks, the missed periods were not dropped",
+                (unsigned) count);
+}
+
+RART_TEST(rart_timer, periodic_burst_missed) {
+    static recorder_t recorder = {.stall_us = 35000};
+    void *timer = rtos_timer_periodic_start(count_callback, &recorder, 10,
+                                            RART_TIMER_MISSED_BURST);
+
+    RART_ASSERT_NOT_NULL(timer);
+    rart_test_sleep(205);
+
+    uint32_t missed = rtos_timer_periodic_missed(timer);
+    rtos_timer_periodic_stop(timer);
+    uint32_t count = atomic_load(&recorder.count);
+
+    /* The late periods are called back to back, so none is lost */
+    RART_ASSERT(missed >= 2, "%u periods missed, expected at least 2", (unsigned) missed);
+    RART_ASSERT(count >= 19, "%u callbacks, expected one per period", (unsigned) count);
+}
+
+RART_TEST(rart_timer, pool_size) {
+    static recorder_t recorder;
+    void *timers[NUM_OF_TIMERS];
+
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        timers[i] = rtos_timer_periodic_start(count_callback, &recorder, 1000,
+                                              RART_TIMER_MISSED_SKIP);
+        RART_ASSERT_NOT_NULL(timers[i]);
+    }
+
+#if !defined(CONFIG_RART_POOL_OVERFLOW)
+    RART_ASSERT_NULL(rtos_timer_periodic_start(count_callback, &recorder, 1000,
+                                               RART_TIMER_MISSED_SKIP));
+#endif
+
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        rtos_timer_periodic_stop(timers[i]);
+    }
+
+    /* Every timer is back in the pool */
+    rtos_timer_reschedule(count_callback, &recorder, 0);
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Timer did not expire");
+}
+
+static void count_callback(const void *state) {
+    recorder_t *recorder = (recorder_t *) state;
+    bool is_first        = atomic_load(&recorder->count) == 0;
+
+    /* The callbacks of a timer never overlap, and the count publishes first_us */
+    if (is_first) {
+        recorder->first_us = rart_test_now_us();
+    }
+    atomic_fetch_add(&recorder->count, 1);
+
+    if (is_first) {
+        rart_test_busy_wait(recorder->stall_us);
+    }
+}
+
+static void tag_callback(const void *state) {
+    const tagged_t *tagged = state;
+    uint32_t count         = atomic_load(&tagged->recorder->count);
+
+    if (count < RECORD_MAX) {
+        tagged->recorder->order[count] = tagged->tag;
+    }
+    atomic_fetch_add(&tagged->recorder->count, 1);
+}
+
+static bool wait_count(recorder_t *recorder, uint32_t count, uint32_t timeout) {
+    uint64_t end = rart_test_now_us() + (uint64_t) timeout * 1000;
+
+    while (atomic_load(&recorder->count) < count) {
+        if (rart_test_now_us() > end) {
+            return false;
+        }
+        rart_test_sleep(1);
+    }
+
+    return true;
+}
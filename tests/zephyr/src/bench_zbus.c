@@ -0,0 +1,184 @@
+/**
+ * @file bench_zbus.c
+ * @brief Micro-benchmarks of the zbus backend, run with the rart_bench suite
+ * @version 0.1
+ */
+#include <zbus.h>
+
+#include "rart-test.h"
+#include "zbus-backend-defines.h"
+#include "zbus-backend.h"
+#include "zbus_messages.h"
+
+/**
+ * @brief Publications measured
+ */
+#define BENCH_LATENCY_ITERATIONS 100
+
+/**
+ * @brief Channels of the dispatch benchmark
+ */
+#define BENCH_DISPATCH_CHANNELS 16
+
+/**
+ * @brief Observers of each channel in the dispatch benchmark
+ */
+#define BENCH_DISPATCH_OBSERVERS 4
+
+/**
+ * @brief Rounds of the dispatch benchmark
+ */
+#define BENCH_DISPATCH_ITERATIONS 10
+
+BUILD_ASSERT(NUM_OF_CHANNELS >= BENCH_DISPATCH_CHANNELS,
+             "The dispatch benchmark spans 16 channels");
+
+/**
+ * @brief Time an observer ran, published with a flag so 32 bit targets need no 64 bit
+ * atomics
+ */
+typedef struct {
+    atomic_t called; /**< Set after stamp is written */
+    uint64_t stamp;  /**< rart_bench_now in the observer */
+} bench_stamp_t;
+
+/**
+ * @brief Listener of every channel, forwarding to the RART backend
+ *
+ * @param idx Channel index
+ */
+static void rart_listener_callback(zbus_channel_index_t idx);
+
+ZBUS_LISTENER_DECLARE(rart_listener, rart_listener_callback);
+
+/**
+ * @brief Listener of the application on the counter channel, checked by the zbus suite
+ *
+ * @param idx Channel index
+ */
+static void app_listener_callback(zbus_channel_index_t idx);
+
+ZBUS_LISTENER_DECLARE(app_listener, app_listener_callback);
+
+/**
+ * @brief Measure the time from a publication to its observer
+ *
+ * @param name[in] Operation reported
+ * @param id Channel index
+ * @param size Message size of the channel
+ */
+static void bench_publish_to_observer(const char *name, uint32_t id, uint32_t size);
+
+/**
+ * @brief Observer callback recording the counter when it runs
+ *
+ * @param state bench_stamp_t
+ * @param data Message
+ * @param data_len Message size
+ */
+static void stamp_callback(void *state, void *data, uint32_t data_len);
+
+/**
+ * @brief Observer callback counting its calls
+ *
+ * @param state atomic_t
+ * @param data Message
+ * @param data_len Message size
+ */
+static void count_callback(void *state, void *data, uint32_t data_len);
+
+RART_TEST(rart_bench, zbus_publish_to_observer) {
+    bench_publish_to_observer("zbus_publish_to_observer", ZBUS_BACKEND_CHAN_COUNTER,
+                              sizeof(struct counter_msg));
+}
+
+/* Run with and without CONFIG_RART_ZBUS_ZERO_COPY to compare the copy of the message */
+RART_TEST(rart_bench, zbus_publish_to_observer_large) {
+    bench_publish_to_observer("zbus_publish_to_observer_256", ZBUS_BACKEND_CHAN_BLOB_256,
+                              sizeof(struct blob_256_msg));
+    bench_publish_to_observer("zbus_publish_to_observer_1024", ZBUS_BACKEND_CHAN_BLOB_1K,
+                              sizeof(struct blob_1k_msg));
+}
+
+RART_TEST(rart_bench, zbus_dispatch_64_observers) {
+    static const uint32_t size[NUM_OF_CHANNELS] = CHANNEL_MESSAGE_SIZES;
+    static atomic_t count;
+    uint32_t msg[2] = {0};
+    uint64_t total  = 0;
+
+    for (int i = 0; i < BENCH_DISPATCH_ITERATIONS; ++i) {
+        atomic_clear(&count);
+        for (uint32_t id = 0; id < BENCH_DISPATCH_CHANNELS; ++id) {
+            for (int j = 0; j < BENCH_DISPATCH_OBSERVERS; ++j) {
+                RART_ASSERT_EQ(rtos_zbus_register_observer(id, &count, count_callback), 0);
+            }
+        }
+
+        /* One publication per channel, each one reaching the observers of its channel */
+        uint64_t start = rart_bench_now();
+        for (uint32_t id = 0; id < BENCH_DISPATCH_CHANNELS; ++id) {
+            RART_ASSERT_EQ(rtos_zbus_publish(id, msg, size[id]), 0);
+        }
+
+        int64_t deadline = k_uptime_get() + 100;
+        while (atomic_get(&count) < BENCH_DISPATCH_CHANNELS * BENCH_DISPATCH_OBSERVERS) {
+            RART_ASSERT(k_uptime_get() < deadline, "Observers not called");
+            k_yield();
+        }
+
+        total += rart_bench_now() - start;
+    }
+
+    rart_bench_report("zbus_dispatch_16_channels_64_observers",
+                      total / BENCH_DISPATCH_ITERATIONS, NULL);
+}
+
+static void bench_publish_to_observer(const char *name, uint32_t id, uint32_t size) {
+    static bench_stamp_t stamp;
+    static uint8_t msg[sizeof(struct blob_1k_msg)];
+    uint64_t total = 0;
+
+    for (int i = 0; i < BENCH_LATENCY_ITERATIONS; ++i) {
+        atomic_clear(&stamp.called);
+        RART_ASSERT_EQ(rtos_zbus_register_observer(id, &stamp, stamp_callback), 0);
+
+        msg[0] = i;
+        uint64_t start = rart_bench_now();
+        RART_ASSERT_EQ(rtos_zbus_publish(id, msg, size), 0);
+
+        int64_t deadline = k_uptime_get() + 100;
+        while (!atomic_get(&stamp.called)) {
+            RART_ASSERT(k_uptime_get() < deadline, "Observer not called");
+            k_msleep(1);
+        }
+
+        total += stamp.stamp - start;
+    }
+
+    rart_bench_report(name, total / BENCH_LATENCY_ITERATIONS, NULL);
+}
+
+static void rart_listener_callback(zbus_channel_index_t idx) {
+    rtos_zbus_default_listener_callback(idx);
+}
+
+static void app_listener_callback(zbus_channel_index_t idx) {
+    ARG_UNUSED(idx);
+}
+
+static void stamp_callback(void *state, void *data, uint32_t data_len) {
+    ARG_UNUSED(data);
+    ARG_UNUSED(data_len);
+
+    bench_stamp_t *stamp = state;
+
+    stamp->stamp = rart_bench_now();
+    atomic_set(&stamp->called, 1);
+}
+
+static void count_callback(void *state, void *data, uint32_t data_len) {
+    ARG_UNUSED(data);
+    ARG_UNUSED(data_len);
+
+    atomic_inc(state);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file harness.c
+ * @brief Zephyr side of the RART suite harness: threads, time and benchmark output
+ * @version 0.1
+ */
+#include <stdio.h>
+#include <zephyr.h>
+
+#include "rart-pool.h"
+#include "rart-test.h"
+
+/**
+ * @brief Stack size of the test threads
+ */
+#define TEST_STACK_SIZE 2048
+
+/**
+ * @brief Priority of the test threads, the same as the ztest thread
+ */
+#define TEST_PRIORITY K_PRIO_PREEMPT(CONFIG_ZTEST_THREAD_PRIORITY)
+
+/**
+ * @brief Size of the benchmark results, in JSON
+ */
+#define BENCH_JSON_SIZE 4096
+
+/**
+ * @brief Stacks of the test threads
+ */
+K_THREAD_STACK_ARRAY_DEFINE(test_stacks, RART_TEST_THREADS, TEST_STACK_SIZE);
+
+/**
+ * @brief Bitmap of the stacks in use
+ */
+static ATOMIC_DEFINE(test_stacks_used, RART_TEST_THREADS);
+
+/**
+ * @brief Adapt the entry point of a test thread to k_thread_create
+ *
+ * @param fn Entry point
+ * @param arg Argument of the entry point
+ * @param unused Unused
+ */
+static void thread_entry(void *fn, void *arg, void *unused);
+
+void rart_test_thread_start(rart_test_thread_t *thread, rart_test_thread_fn_t fn, void *arg) {
+    thread->slot = rart_bitmap_claim(test_stacks_used, RART_TEST_THREADS);
+    zassert_true(thread->slot >= 0, "More than %d test threads", RART_TEST_THREADS);
+
+    k_thread_create(&thread->thread, test_stacks[thread->slot], TEST_STACK_SIZE, thread_entry,
+                    fn, arg, NULL, TEST_PRIORITY, 0, K_NO_WAIT);
+}
+
+void rart_test_thread_join(rart_test_thread_t *thread) {
+    k_thread_join(&thread->thread, K_FOREVER);
+    rart_bitmap_release(test_stacks_used, thread->slot);
+}
+
+void rart_test_sleep(uint32_t ms) {
+    k_msleep(ms);
+}
+
+void rart_test_yield(void) {
+    k_yield();
+}
+
+void rart_test_busy_wait(uint32_t us) {
+    k_busy_wait(us);
+}
+
+uint64_t rart_test_now_us(void) {
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+uint64_t rart_bench_now(void) {
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+    return k_cycle_get_64();
+#else
+    /* Extend the 32 bit counter, the benchmarks read it more often than it wraps */
+    static uint64_t high;
+    static uint32_t last;
+    uint32_t now = k_cycle_get_32();
+
+    if (now < last) {
+        high += (uint64_t) 1 << 32;
+    }
+    last = now;
+
+    return high | now;
+#endif
+}
+
+void rart_bench_flush(void) {
+    static char json[BENCH_JSON_SIZE];
+
+    if (rart_bench_json(json, sizeof(json), CONFIG_BOARD) == 0) {
+        return;
+    }
+
+    printf("RART-BENCH-BEGIN\n%sRART-BENCH-END\n", json);
+}
+
+static void thread_entry(void *fn, void *arg, void *unused) {
+    ARG_UNUSED(unused);
+
+    ((rart_test_thread_fn_t) fn)(arg);
+}
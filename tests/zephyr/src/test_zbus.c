@@ -0,0 +1,725 @@
+/**
+ * @file test_zbus.c
+ * @brief Conformance of the zbus backend ABI: observers, publication and subscriptions
+ * @version 0.1
+ */
+#include <errno.h>
+#include <string.h>
+#include <zbus.h>
+
+#include "rart-test.h"
+#include "zbus-backend-defines.h"
+#include "zbus-backend.h"
+#include "zbus_messages.h"
+
+/**
+ * @brief Maximum number of calls recorded by a recorder
+ */
+#define RECORD_MAX 8
+
+/**
+ * @brief Threads registering observers in the concurrent tests
+ */
+#define REGISTRARS 3
+
+/**
+ * @brief Registrations tried, and publications, by each thread of the concurrent tests
+ */
+#define REGISTRATIONS 500
+
+/**
+ * @brief Calls seen by the backend callbacks of a test
+ */
+typedef struct {
+    atomic_t count;               /**< Number of calls */
+    uint32_t data[RECORD_MAX];    /**< First word of the message of each call */
+    uint32_t size[RECORD_MAX];    /**< Message size, or result, of each call */
+} recorder_t;
+
+/**
+ * @brief Counters shared by the threads of the concurrent tests
+ */
+typedef struct {
+    atomic_t registered; /**< Observers registered */
+    atomic_t calls;      /**< Calls of the observers */
+    atomic_t failures;   /**< Registrations or publications that failed */
+} set_churn_t;
+
+/**
+ * @brief Observer state recording a tag in the call order
+ */
+typedef struct {
+    recorder_t *recorder; /**< Recorder of the test */
+    uint32_t tag;         /**< Value recorded instead of the message */
+} tagged_t;
+
+/**
+ * @brief Subscriber state cancelling subscriptions from its callback
+ */
+typedef struct {
+    recorder_t *recorder; /**< Recorder of the test, with the result of each unsubscribe */
+    int32_t handles[2];   /**< Subscriptions cancelled, its own first */
+} unsubscriber_t;
+
+/**
+ * @brief Listener of every channel, forwarding to the RART backend
+ *
+ * @param idx Channel index
+ */
+static void rart_listener_callback(zbus_channel_index_t idx);
+
+ZBUS_LISTENER_DECLARE(rart_listener, rart_listener_callback);
+
+/**
+ * @brief Listener of the application on the counter channel, counting its calls
+ *
+ * @param idx Channel index
+ */
+static void app_listener_callback(zbus_channel_index_t idx);
+
+ZBUS_LISTENER_DECLARE(app_listener, app_listener_callback);
+
+/**
+ * @brief Calls of the application listener
+ */
+static atomic_t app_listener_calls;
+
+/**
+ * @brief Observer callback recording the first word of the message
+ *
+ * @param state recorder_t
+ * @param data Message
+ * @param data_len Message size
+ */
+static void record_callback(void *state, void *data, uint32_t data_len);
+
+/**
+ * @brief Observer callback recording its tag
+ *
+ * @param state tagged_t
+ * @param data Message
+ * @param data_len Message size
+ */
+static void tag_callback(void *state, void *data, uint32_t data_len);
+
+/**
+ * @brief Observer callback counting its calls
+ *
+ * @param state atomic_t
+ * @param data Message
+ * @param data_len Message size
+ */
+static void count_callback(void *state, void *data, uint32_t data_len);
+
+/**
+ * @brief Subscriber callback cancelling the subscriptions of its state and recording the
+ * results
+ *
+ * @param state unsubscriber_t
+ * @param data Message
+ * @param data_len Message size
+ */
+static void unsubscribe_callback(void *state, void *data, uint32_t data_len);
+
+/**
+ * @brief Publish callback recording its result
+ *
+ * @param state recorder_t
+ * @param result Result of the wait
+ */
+static void publish_callback(void *state, int32_t result);
+
+/**
+ * @brief Set observer callback recording the changed channels
+ *
+ * @param state recorder_t
+ * @param changed Mask of the changed channels
+ */
+static void set_callback(void *state, uint32_t changed);
+
+/**
+ * @brief Set observer callback counting its calls
+ *
+ * @param state atomic_t
+ * @param changed Mask of the changed channels
+ */
+static void count_set_callback(void *state, uint32_t changed);
+
+/**
+ * @brief Register set observers on the sample channel, REGISTRATIONS times
+ *
+ * @param arg set_churn_t
+ */
+static void register_thread(void *arg);
+
+/**
+ * @brief Register one-shot observers on the sample channel, REGISTRATIONS times
+ *
+ * @param arg set_churn_t
+ */
+static void observe_thread(void *arg);
+
+/**
+ * @brief Publish on the sample channel, REGISTRATIONS times
+ *
+ * @param arg set_churn_t
+ */
+static void publish_thread(void *arg);
+
+/**
+ * @brief Dispatch the counter channel, as its listener does
+ *
+ * @param arg Unused
+ */
+static void dispatch_thread(void *arg);
+
+/**
+ * @brief Wait until a recorder sees a number of calls
+ *
+ * @param recorder[in] Recorder
+ * @param count Expected number of calls
+ * @param timeout Maximum wait, in milliseconds
+ * @return bool True if the calls arrived in time.
+ */
+static bool wait_count(recorder_t *recorder, uint32_t count, uint32_t timeout);
+
+/**
+ * @brief Clear a recorder
+ *
+ * @param recorder[out] Recorder
+ */
+static void recorder_reset(recorder_t *recorder);
+
+RART_TEST_SUITE(rart_zbus, NULL);
+
+RART_TEST(rart_zbus, publish_observe) {
+    static recorder_t recorder;
+    struct counter_msg msg = {.value = 42};
+
+    recorder_reset(&recorder);
+    RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                               record_callback),
+                   0);
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Observer not called");
+    RART_ASSERT_EQ(recorder.data[0], 42);
+    RART_ASSERT_EQ(recorder.size[0], sizeof(msg));
+
+    /* One-shot: the next message is not delivered */
+    msg.value = 43;
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&recorder.count), 1);
+}
+
+RART_TEST(rart_zbus, observers_in_order) {
+    static recorder_t recorder;
+    static tagged_t tags[3] = {{&recorder, 1}, {&recorder, 2}, {&recorder, 3}};
+    struct sample_msg msg   = {.sequence = 1, .value = -1};
+
+    recorder_reset(&recorder);
+    for (int i = 0; i < 3; ++i) {
+        RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_SAMPLE, &tags[i],
+                                                   tag_callback),
+                       0);
+    }
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_SAMPLE, &msg, sizeof(msg)), 0);
+
+    RART_ASSERT(wait_count(&recorder, 3, 100), "Observers not called");
+    RART_ASSERT_EQ(recorder.data[0], 1);
+    RART_ASSERT_EQ(recorder.data[1], 2);
+    RART_ASSERT_EQ(recorder.data[2], 3);
+}
+
+RART_TEST(rart_zbus, invalid_channel) {
+    static recorder_t recorder;
+    uint32_t msg = 0;
+
+    RART_ASSERT_EQ(rtos_zbus_register_observer(NUM_OF_CHANNELS, &recorder, record_callback),
+                   -EINVAL);
+    RART_ASSERT_EQ(rtos_zbus_publish(NUM_OF_CHANNELS, &msg, sizeof(msg)), -EINVAL);
+    RART_ASSERT_EQ(rtos_zbus_register_set_observer(0, &recorder, set_callback), -EINVAL);
+}
+
+RART_TEST(rart_zbus, observer_pool) {
+    static recorder_t recorder;
+    struct counter_msg msg = {.value = 7};
+
+    recorder_reset(&recorder);
+    for (int i = 0; i < NUM_OF_OBSERVERS; ++i) {
+        RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                                   record_callback),
+                       0);
+    }
+    RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                               record_callback),
+                   -ENOMEM);
+
+    /* The publication releases every observer */
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    RART_ASSERT(wait_count(&recorder, NUM_OF_OBSERVERS, 100), "Observers not called");
+    RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                               record_callback),
+                   0);
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+}
+
+/* A dispatch detaching the list between the read and the write of its tail by a
+ * registration used to leave a stale tail, and the channel silent for good */
+RART_TEST(rart_zbus, observer_concurrent) {
+    static set_churn_t churn;
+    rart_test_thread_t threads[REGISTRARS + 1];
+    struct sample_msg msg = {.sequence = 5};
+
+    memset(&churn, 0, sizeof(churn));
+    for (int i = 0; i < REGISTRARS; ++i) {
+        rart_test_thread_start(&threads[i], observe_thread, &churn);
+    }
+    rart_test_thread_start(&threads[REGISTRARS], publish_thread, &churn);
+    for (int i = 0; i <= REGISTRARS; ++i) {
+        rart_test_thread_join(&threads[i]);
+    }
+
+    RART_ASSERT_EQ(atomic_get(&churn.failures), 0);
+    RART_ASSERT(atomic_get(&churn.registered) > 0, "No observer registered");
+
+    /* The last publication reaches every observer left, each one is called once */
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_SAMPLE, &msg, sizeof(msg)), 0);
+
+    int64_t end = k_uptime_get() + 100;
+    while (atomic_get(&churn.calls) < atomic_get(&churn.registered)) {
+        RART_ASSERT(k_uptime_get() < end, "Observers not called");
+        k_msleep(1);
+    }
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&churn.calls), atomic_get(&churn.registered));
+}
+
+RART_TEST(rart_zbus, set_observer) {
+    static recorder_t recorder;
+    struct sample_msg msg = {.sequence = 2};
+    uint32_t mask         = BIT(ZBUS_BACKEND_CHAN_COUNTER) | BIT(ZBUS_BACKEND_CHAN_SAMPLE);
+
+    recorder_reset(&recorder);
+    RART_ASSERT_EQ(rtos_zbus_register_set_observer(mask, &recorder, set_callback), 0);
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_SAMPLE, &msg, sizeof(msg)), 0);
+
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Set observer not called");
+    RART_ASSERT_EQ(recorder.data[0], BIT(ZBUS_BACKEND_CHAN_SAMPLE));
+
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_SAMPLE, &msg, sizeof(msg)), 0);
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&recorder.count), 1);
+}
+
+/* On SMP the registrations and the dispatches run on several cores at once */
+RART_TEST(rart_zbus, set_observer_concurrent) {
+    static set_churn_t churn;
+    rart_test_thread_t threads[REGISTRARS + 1];
+    struct sample_msg msg = {.sequence = 3};
+
+    memset(&churn, 0, sizeof(churn));
+    for (int i = 0; i < REGISTRARS; ++i) {
+        rart_test_thread_start(&threads[i], register_thread, &churn);
+    }
+    rart_test_thread_start(&threads[REGISTRARS], publish_thread, &churn);
+    for (int i = 0; i <= REGISTRARS; ++i) {
+        rart_test_thread_join(&threads[i]);
+    }
+
+    RART_ASSERT_EQ(atomic_get(&churn.failures), 0);
+    RART_ASSERT(atomic_get(&churn.registered) > 0, "No set observer registered");
+
+    /* The last publication releases the observers left, each one is called once */
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_SAMPLE, &msg, sizeof(msg)), 0);
+
+    int64_t end = k_uptime_get() + 100;
+    while (atomic_get(&churn.calls) < atomic_get(&churn.registered)) {
+        RART_ASSERT(k_uptime_get() < end, "Set observers not called");
+        k_msleep(1);
+    }
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&churn.calls), atomic_get(&churn.registered));
+}
+
+RART_TEST(rart_zbus, borrow_finish) {
+    struct counter_msg msg = {.value = 99};
+    const void *borrowed   = NULL;
+    uint32_t size          = 0;
+
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    RART_ASSERT_EQ(rtos_zbus_borrow(ZBUS_BACKEND_CHAN_COUNTER, &borrowed, &size, 100), 0);
+    RART_ASSERT_NOT_NULL(borrowed);
+    RART_ASSERT_EQ(size, sizeof(msg));
+    RART_ASSERT_EQ(((const struct counter_msg *) borrowed)->value, 99);
+
+    /* The borrowed channel refuses publications until it is finished */
+    RART_ASSERT(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)) != 0,
+                "Published on a borrowed channel");
+    RART_ASSERT_EQ(rtos_zbus_finish(ZBUS_BACKEND_CHAN_COUNTER), 0);
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+}
+
+RART_TEST(rart_zbus, dispatch_claimed_channel) {
+    static recorder_t recorder;
+    zbus_backend_publish_stats_t before;
+    zbus_backend_publish_stats_t after;
+    rart_test_thread_t thread;
+    struct counter_msg msg = {.value = 41};
+    const void *borrowed;
+    uint32_t size;
+
+    recorder_reset(&recorder);
+    RART_ASSERT_EQ(rtos_zbus_publish_stats_get(ZBUS_BACKEND_CHAN_COUNTER, &before), 0);
+    RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                               record_callback),
+                   0);
+
+    /* A dispatch from another thread cannot read the borrowed channel */
+    RART_ASSERT_EQ(rtos_zbus_borrow(ZBUS_BACKEND_CHAN_COUNTER, &borrowed, &size, 100), 0);
+    rart_test_thread_start(&thread, dispatch_thread, NULL);
+    rart_test_thread_join(&thread);
+    RART_ASSERT_EQ(rtos_zbus_finish(ZBUS_BACKEND_CHAN_COUNTER), 0);
+
+    RART_ASSERT_EQ(atomic_get(&recorder.count), 0);
+    RART_ASSERT_EQ(rtos_zbus_publish_stats_get(ZBUS_BACKEND_CHAN_COUNTER, &after), 0);
+    RART_ASSERT_EQ(after.missed, before.missed + 1);
+
+    /* The observer was kept for the next message */
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Observer not called");
+    RART_ASSERT_EQ(recorder.data[0], 41);
+}
+
+RART_TEST(rart_zbus, publish_async_woken) {
+    static recorder_t recorder;
+    struct counter_msg msg = {.value = 5};
+    const void *borrowed;
+    uint32_t size;
+
+    recorder_reset(&recorder);
+    RART_ASSERT_EQ(rtos_zbus_borrow(ZBUS_BACKEND_CHAN_COUNTER, &borrowed, &size, 100), 0);
+    RART_ASSERT_EQ(rtos_zbus_publish_async(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg),
+                                           &recorder, publish_callback, 1000),
+                   -EINPROGRESS);
+
+    RART_ASSERT_EQ(atomic_get(&recorder.count), 0);
+    RART_ASSERT_EQ(rtos_zbus_finish(ZBUS_BACKEND_CHAN_COUNTER), 0);
+
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Publisher not woken");
+    RART_ASSERT_EQ((int32_t) recorder.size[0], 0);
+}
+
+RART_TEST(rart_zbus, publish_async_timeout) {
+    static recorder_t recorder;
+    zbus_backend_publish_stats_t stats;
+    struct counter_msg msg = {.value = 6};
+    const void *borrowed;
+    uint32_t size;
+
+    recorder_reset(&recorder);
+    RART_ASSERT_EQ(rtos_zbus_borrow(ZBUS_BACKEND_CHAN_COUNTER, &borrowed, &size, 100), 0);
+    RART_ASSERT_EQ(rtos_zbus_publish_async(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg),
+                                           &recorder, publish_callback, 20),
+                   -EINPROGRESS);
+
+    RART_ASSERT(wait_count(&recorder, 1, 200), "Wait did not expire");
+    RART_ASSERT_EQ((int32_t) recorder.size[0], -EAGAIN);
+    RART_ASSERT_EQ(rtos_zbus_finish(ZBUS_BACKEND_CHAN_COUNTER), 0);
+
+    RART_ASSERT_EQ(rtos_zbus_publish_stats_get(ZBUS_BACKEND_CHAN_COUNTER, &stats), 0);
+    RART_ASSERT(stats.timeouts >= 1, "Timeout not counted");
+
+    /* The expired waiter is not called again */
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&recorder.count), 1);
+}
+
+RART_TEST(rart_zbus, publish_async_external_claim) {
+    static recorder_t recorder;
+    struct counter_msg msg       = {.value = 8};
+    struct zbus_channel *channel = zbus_chan_get_by_index(ZBUS_BACKEND_CHAN_COUNTER);
+
+    recorder_reset(&recorder);
+    RART_ASSERT_EQ(zbus_chan_claim(channel, K_MSEC(100)), 0);
+    RART_ASSERT_EQ(rtos_zbus_publish_async(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg),
+                                           &recorder, publish_callback, 1000),
+                   -EINPROGRESS);
+
+    /* Released without the backend, the waiter sees it by polling the channel */
+    RART_ASSERT_EQ(zbus_chan_finish(channel), 0);
+    RART_ASSERT(wait_count(&recorder, 1, 100), "Publisher not woken");
+    RART_ASSERT_EQ((int32_t) recorder.size[0], 0);
+}
+
+RART_TEST(rart_zbus, batch) {
+    static recorder_t observers;
+    static recorder_t set;
+    struct counter_msg counter = {.value = 11};
+    struct sample_msg sample   = {.sequence = 12};
+    zbus_backend_batch_item_t items[] = {
+            {ZBUS_BACKEND_CHAN_COUNTER, &counter, sizeof(counter)},
+            {ZBUS_BACKEND_CHAN_SAMPLE, &sample, sizeof(sample)},
+    };
+    uint32_t mask = BIT(ZBUS_BACKEND_CHAN_COUNTER) | BIT(ZBUS_BACKEND_CHAN_SAMPLE);
+
+    recorder_reset(&observers);
+    recorder_reset(&set);
+    RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_COUNTER, &observers,
+                                               record_callback),
+                   0);
+    RART_ASSERT_EQ(rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_SAMPLE, &observers,
+                                               record_callback),
+                   0);
+    RART_ASSERT_EQ(rtos_zbus_register_set_observer(mask, &set, set_callback), 0);
+
+    RART_ASSERT_EQ(rtos_zbus_publish_batch(items, ARRAY_SIZE(items)), 0);
+
+    RART_ASSERT(wait_count(&observers, 2, 100), "Observers not called");
+    RART_ASSERT(wait_count(&set, 1, 100), "Set observer not called");
+    RART_ASSERT_EQ(set.data[0], mask);
+
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&set.count), 1);
+}
+
+RART_TEST(rart_zbus, batch_reaches_listeners) {
+    struct counter_msg counter        = {.value = 21};
+    zbus_backend_batch_item_t items[] = {
+            {ZBUS_BACKEND_CHAN_COUNTER, &counter, sizeof(counter)},
+    };
+    atomic_val_t calls = atomic_get(&app_listener_calls);
+
+    RART_ASSERT_EQ(rtos_zbus_publish_batch(items, ARRAY_SIZE(items)), 0);
+    RART_ASSERT_EQ(atomic_get(&app_listener_calls), calls + 1);
+}
+
+RART_TEST(rart_zbus, batch_invalid) {
+    uint32_t value = 0;
+    zbus_backend_batch_item_t items[] = {
+            {ZBUS_BACKEND_CHAN_COUNTER, &value, sizeof(value) + 1},
+    };
+
+    RART_ASSERT_EQ(rtos_zbus_publish_batch(items, ARRAY_SIZE(items)), -EINVAL);
+    RART_ASSERT_EQ(rtos_zbus_publish_batch(NULL, 1), -EINVAL);
+}
+
+RART_TEST(rart_zbus, batch_repeated_channel) {
+    struct counter_msg first          = {.value = 1};
+    struct counter_msg second         = {.value = 2};
+    zbus_backend_batch_item_t items[] = {
+            {ZBUS_BACKEND_CHAN_COUNTER, &first, sizeof(first)},
+            {ZBUS_BACKEND_CHAN_COUNTER, &second, sizeof(second)},
+    };
+
+    RART_ASSERT_EQ(rtos_zbus_publish_batch(items, ARRAY_SIZE(items)), -EINVAL);
+}
+
+#if NUM_OF_SUBSCRIBERS > 0
+RART_TEST(rart_zbus, subscription) {
+    static recorder_t recorder;
+    struct counter_msg msg;
+    struct counter_msg out;
+
+    recorder_reset(&recorder);
+    int32_t handle = rtos_zbus_subscribe(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                         record_callback);
+    RART_ASSERT(handle >= 0, "Subscription failed: %d", handle);
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        msg.value = 100 + i;
+        RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    }
+
+    RART_ASSERT(wait_count(&recorder, 3, 100), "Subscriber not woken");
+    for (uint32_t i = 0; i < 3; ++i) {
+        RART_ASSERT_EQ(rtos_zbus_subscription_recv(handle, &out), 0);
+        RART_ASSERT_EQ(out.value, 100 + i);
+    }
+    RART_ASSERT_EQ(rtos_zbus_subscription_recv(handle, &out), -ENOMSG);
+
+    RART_ASSERT_EQ(rtos_zbus_unsubscribe(handle), 0);
+    RART_ASSERT_EQ(rtos_zbus_unsubscribe(handle), -EINVAL);
+    RART_ASSERT_EQ(rtos_zbus_subscription_recv(handle, &out), -EINVAL);
+}
+
+RART_TEST(rart_zbus, unsubscribe_from_callback) {
+    static recorder_t recorder;
+    static recorder_t other;
+    static unsubscriber_t unsubscriber;
+    struct counter_msg msg = {.value = 31};
+
+    recorder_reset(&recorder);
+    recorder_reset(&other);
+
+    /* Subscribers are woken newest first, so the callback cancels both before the other
+     * subscriber is woken */
+    int32_t handle = rtos_zbus_subscribe(ZBUS_BACKEND_CHAN_COUNTER, &other, record_callback);
+    RART_ASSERT(handle >= 0, "Subscription failed: %d", handle);
+    unsubscriber.recorder   = &recorder;
+    unsubscriber.handles[1] = handle;
+
+    handle = rtos_zbus_subscribe(ZBUS_BACKEND_CHAN_COUNTER, &unsubscriber,
+                                 unsubscribe_callback);
+    RART_ASSERT(handle >= 0, "Subscription failed: %d", handle);
+    unsubscriber.handles[0] = handle;
+
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    RART_ASSERT(wait_count(&recorder, 2, 100), "Subscriber not woken");
+    RART_ASSERT_EQ((int32_t) recorder.size[0], 0);
+    RART_ASSERT_EQ((int32_t) recorder.size[1], 0);
+
+    /* Both are gone: neither woken again, and the slots are free for new subscriptions */
+    RART_ASSERT_EQ(rtos_zbus_publish(ZBUS_BACKEND_CHAN_COUNTER, &msg, sizeof(msg)), 0);
+    k_msleep(10);
+    RART_ASSERT_EQ(atomic_get(&recorder.count), 2);
+    RART_ASSERT_EQ(atomic_get(&other.count), 0);
+
+    for (int i = 0; i < 2; ++i) {
+        handle = rtos_zbus_subscribe(ZBUS_BACKEND_CHAN_COUNTER, &other, record_callback);
+        RART_ASSERT(handle >= 0, "Subscription failed: %d", handle);
+        RART_ASSERT_EQ(rtos_zbus_unsubscribe(handle), 0);
+    }
+}
+#else
+RART_TEST(rart_zbus, subscription_not_supported) {
+    static recorder_t recorder;
+    struct counter_msg out;
+
+    RART_ASSERT_EQ(rtos_zbus_subscribe(ZBUS_BACKEND_CHAN_COUNTER, &recorder,
+                                       record_callback),
+                   -ENOTSUP);
+    RART_ASSERT_EQ(rtos_zbus_unsubscribe(0), -ENOTSUP);
+    RART_ASSERT_EQ(rtos_zbus_subscription_recv(0, &out), -ENOTSUP);
+    RART_ASSERT_EQ(rtos_zbus_subscription_drops(0), 0);
+}
+#endif
+
+static void rart_listener_callback(zbus_channel_index_t idx) {
+    rtos_zbus_default_listener_callback(idx);
+}
+
+static void app_listener_callback(zbus_channel_index_t idx) {
+    ARG_UNUSED(idx);
+
+    atomic_inc(&app_listener_calls);
+}
+
+static void record_callback(void *state, void *data, uint32_t data_len) {
+    recorder_t *recorder = state;
+    atomic_val_t count   = atomic_get(&recorder->count);
+
+    if (count < RECORD_MAX) {
+        recorder->data[count] = (data != NULL) ? *(uint32_t *) data : 0;
+        recorder->size[count] = data_len;
+    }
+    atomic_inc(&recorder->count);
+}
+
+static void tag_callback(void *state, void *data, uint32_t data_len) {
+    tagged_t *tagged = state;
+
+    ARG_UNUSED(data);
+    record_callback(tagged->recorder, &tagged->tag, data_len);
+}
+
+static void count_callback(void *state, void *data, uint32_t data_len) {
+    ARG_UNUSED(data);
+    ARG_UNUSED(data_len);
+
+    atomic_inc(state);
+}
+
+static void unsubscribe_callback(void *state, void *data, uint32_t data_len) {
+    unsubscriber_t *unsubscriber = state;
+
+    ARG_UNUSED(data);
+    ARG_UNUSED(data_len);
+
+    for (int i = 0; i < 2; ++i) {
+        record_callback(unsubscriber->recorder, NULL,
+                        (uint32_t) rtos_zbus_unsubscribe(unsubscriber->handles[i]));
+    }
+}
+
+static void publish_callback(void *state, int32_t result) {
+    record_callback(state, NULL, (uint32_t) result);
+}
+
+static void set_callback(void *state, uint32_t changed) {
+    record_callback(state, &changed, sizeof(changed));
+}
+
+static void count_set_callback(void *state, uint32_t changed) {
+    ARG_UNUSED(changed);
+
+    atomic_inc(state);
+}
+
+static void register_thread(void *arg) {
+    set_churn_t *churn = arg;
+
+    for (int i = 0; i < REGISTRATIONS; ++i) {
+        int32_t ret = rtos_zbus_register_set_observer(BIT(ZBUS_BACKEND_CHAN_SAMPLE),
+                                                      &churn->calls, count_set_callback);
+
+        if (ret == 0) {
+            atomic_inc(&churn->registered);
+        } else if (ret != -ENOMEM) {
+            atomic_inc(&churn->failures);
+        }
+        k_yield();
+    }
+}
+
+static void observe_thread(void *arg) {
+    set_churn_t *churn = arg;
+
+    for (int i = 0; i < REGISTRATIONS; ++i) {
+        int32_t ret = rtos_zbus_register_observer(ZBUS_BACKEND_CHAN_SAMPLE, &churn->calls,
+                                                  count_callback);
+
+        if (ret == 0) {
+            atomic_inc(&churn->registered);
+        } else if (ret != -ENOMEM) {
+            atomic_inc(&churn->failures);
+        }
+        k_yield();
+    }
+}
+
+static void publish_thread(void *arg) {
+    set_churn_t *churn    = arg;
+    struct sample_msg msg = {.sequence = 4};
+
+    for (int i = 0; i < REGISTRATIONS; ++i) {
+        if (rtos_zbus_publish(ZBUS_BACKEND_CHAN_SAMPLE, &msg, sizeof(msg)) != 0) {
+            atomic_inc(&churn->failures);
+        }
+        k_yield();
+    }
+}
+
+static void dispatch_thread(void *arg) {
+    ARG_UNUSED(arg);
+
+    rtos_zbus_default_listener_callback(ZBUS_BACKEND_CHAN_COUNTER);
+}
+
+static bool wait_count(recorder_t *recorder, uint32_t count, uint32_t timeout) {
+    int64_t end = k_uptime_get() + timeout;
+
+    while (atomic_get(&recorder->count) < count) {
+        if (k_uptime_get() > end) {
+            return false;
+        }
+        k_msleep(1);
+    }
+
+    return true;
+}
+
+static void recorder_reset(recorder_t *recorder) {
+    memset(recorder, 0, sizeof(*recorder));
+}
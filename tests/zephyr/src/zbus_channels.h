@@ -0,0 +1,168 @@
+/**
+ * @file zbus_channels.h
+ * @brief Channels of the zbus and bench suites. The order gives the channel indices, it
+ * matches zbus-channels.toml. Every channel is observed by the RART listener, the counter
+ * also by a listener of the application.
+ */
+
+ZBUS_CHANNEL(counter,                   /* Name */
+             false,                     /* Persistent */
+             false,                     /* On changes only */
+             false,                     /* Read only */
+             struct counter_msg,        /* Message type */
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener, app_listener), /* Observers */
+             ZBUS_INIT(0)               /* Initial value */
+)
+
+ZBUS_CHANNEL(sample,
+             false,
+             false,
+             false,
+             struct sample_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_2,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_3,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_4,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_5,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_6,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_7,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_8,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_9,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_10,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_11,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_12,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_13,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_14,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(load_15,
+             false,
+             false,
+             false,
+             struct counter_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(blob_256,
+             false,
+             false,
+             false,
+             struct blob_256_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
+
+ZBUS_CHANNEL(blob_1k,
+             false,
+             false,
+             false,
+             struct blob_1k_msg,
+             ZBUS_CHANNEL_SUBSCRIBERS(rart_listener),
+             ZBUS_INIT(0)
+)
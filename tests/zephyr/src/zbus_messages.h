@@ -0,0 +1,41 @@
+/**
+ * @file zbus_messages.h
+ * @brief Messages of the channels of the zbus and bench suites
+ * @version 0.1
+ */
+
+#ifndef ZBUS_MESSAGES_H
+#define ZBUS_MESSAGES_H
+
+#include <stdint.h>
+
+/**
+ * @brief Message of the counter channel
+ */
+struct counter_msg {
+    uint32_t value; /**< Counter value */
+};
+
+/**
+ * @brief Message of the sample channel
+ */
+struct sample_msg {
+    uint32_t sequence; /**< Sample number */
+    int32_t value;     /**< Sample value */
+};
+
+/**
+ * @brief Message of the blob_256 channel, large enough to show the cost of a copy
+ */
+struct blob_256_msg {
+    uint8_t data[256]; /**< Payload */
+};
+
+/**
+ * @brief Message of the blob_1k channel
+ */
+struct blob_1k_msg {
+    uint8_t data[1024]; /**< Payload */
+};
+
+#endif /* ZBUS_MESSAGES_H */
@@ -9,140 +9,1187 @@
  *
  */
 #include <stdint.h>
+#include <string.h>
 #include <zbus.h>
 
+#include "rart-pool.h"
+#include "rart.h"
 #include "zbus-backend-defines.h"
+#include "zbus-backend.h"
 
 /**
- * @brief Invalid Zbus Channel ID
+ * @brief Invalid index
  */
-#define INVALID_ID ((uint32_t) -1)
+#define INVALID_INDEX ((zbus_backend_index_t) -1)
 
 /**
- * @brief Invalid index
+ * @brief End of a list. The list links store the entry index plus one, so the list heads
+ * start as zero and are kept in .bss.
  */
-#define INVALID_INDEX ((zbus_backend_index_t) -1)
+#define NO_LINK 0
 
 /**
- * @brief Type of user read callback called inside default zbus read callback.
- *
- * @param state State of the user read callback. This state is required by RART-rs.
- * @param data Data got by ZBUS read operation.
- * @param data_len Data length of ZBUS data read.
+ * @brief Link to an entry index
  */
-typedef void (*zbus_backend_callback_t)(void *state, void *data, uint32_t data_len);
+#define LINK_OF(idx) ((zbus_backend_index_t) ((idx) + 1))
+
+/**
+ * @brief Entry index of a link, not NO_LINK
+ */
+#define INDEX_OF(link) ((zbus_backend_index_t) ((link) - 1))
+
+#ifndef NUM_OF_CHANNELS
+#pragma push_macro("ZBUS_CHANNEL")
+#undef ZBUS_CHANNEL
+#define ZBUS_CHANNEL(name, ...) ZBUS_BACKEND_COUNT_##name,
+
+/**
+ * @brief Channels of zbus, counted from zbus_channels.h when gen_files.py was run
+ * without -c or -C
+ */
+enum zbus_backend_channel_count {
+#include "zbus_channels.h"
+    ZBUS_BACKEND_CHANNEL_COUNT
+};
+
+#pragma pop_macro("ZBUS_CHANNEL")
+
+#define NUM_OF_CHANNELS ZBUS_BACKEND_CHANNEL_COUNT
+#endif
+
+#ifndef NUM_OF_SUBSCRIBERS
+#define NUM_OF_SUBSCRIBERS 0
+#endif
+
+#ifndef SUBSCRIBER_QUEUE_DEPTH
+#define SUBSCRIBER_QUEUE_DEPTH 4
+#endif
+
+#ifndef NUM_OF_PUBLISH_WAITERS
+#define NUM_OF_PUBLISH_WAITERS 4
+#endif
 
 /**
- * @brief Type of the index used in zbus entry list
+ * @brief Type of the index used in zbus entry list. It is as narrow as the largest pool
+ * allows, the all-ones value being reserved for INVALID_INDEX.
  */
+#if NUM_OF_OBSERVERS > 254 || NUM_OF_SUBSCRIBERS > 254 || NUM_OF_PUBLISH_WAITERS > 254
+typedef uint16_t zbus_backend_index_t;
+#else
 typedef uint8_t zbus_backend_index_t;
+#endif
+
+BUILD_ASSERT(NUM_OF_OBSERVERS < UINT16_MAX && NUM_OF_SUBSCRIBERS < UINT16_MAX
+                     && NUM_OF_PUBLISH_WAITERS < UINT16_MAX,
+             "Pools are limited to 65534 entries");
+
+#ifndef NUM_OF_SET_OBSERVERS
+#define NUM_OF_SET_OBSERVERS 4
+#endif
+
+BUILD_ASSERT(NUM_OF_SET_OBSERVERS <= 32, "Set observers are tracked in a 32 bit mask");
+
+/**
+ * @brief Bit of a channel in a channel mask. Only the first 32 channels have one.
+ */
+#define CHANNEL_BIT(id) ((id) < 32 ? (uint32_t) 1 << (id) : 0)
+
+/**
+ * @brief Mask of every channel that can be observed in a set. NUM_OF_CHANNELS may be
+ * counted by the compiler, so the mask is not computed by the preprocessor.
+ */
+#define CHANNEL_MASK_ALL                                                                    \
+    ((NUM_OF_CHANNELS >= 32) ? UINT32_MAX : ((uint32_t) 1 << (NUM_OF_CHANNELS % 32)) - 1)
+
+#ifdef CHANNEL_MESSAGE_SIZES
+#ifdef CHANNEL_MESSAGE_SIZE_MAX
+BUILD_ASSERT(CHANNEL_MESSAGE_SIZE_MAX <= sizeof(zbus_message_variant_t),
+             "A channel of the description is larger than every zbus message");
+#endif
+
+/**
+ * @brief Message size of each channel, generated from the channel description
+ */
+static const uint32_t channel_message_size[NUM_OF_CHANNELS] = CHANNEL_MESSAGE_SIZES;
+
+/**
+ * @brief Message size of a channel
+ */
+#define MESSAGE_SIZE(id) channel_message_size[id]
+#else
+#define MESSAGE_SIZE(id) zbus_chan_get_by_index(id)->message_size
+#endif
 
 /**
- * @brief TODO
+ * @brief Observer registered in a channel
  */
 typedef struct {
-    void *state; /**< TODO */
-    zbus_backend_callback_t callback; /**< TODO */
-    uint32_t id; /**< TODO */
-    bool is_free; /**< TODO */
+    void *state; /**< State passed to the callback */
+    zbus_backend_callback_t callback; /**< Callback called with the channel message */
+    uint32_t id; /**< Channel index */
+    zbus_backend_index_t next; /**< Link to the next observer of the channel */
 } zbus_backend_entry_t;
 
 /**
- * @brief TODO
+ * @brief List of observers of a channel, in registration order
+ */
+typedef struct {
+    zbus_backend_index_t head; /**< Link to the first observer */
+    zbus_backend_index_t tail; /**< Link to the last observer */
+} zbus_backend_list_t;
+
+/**
+ * @brief Pool of observer entries, in entry_pool_objects
+ */
+RART_POOL_DEFINE(entry_pool, zbus_backend_entry_t, NUM_OF_OBSERVERS);
+
+#if NUM_OF_SUBSCRIBERS > 0
+/**
+ * @brief Persistent subscriber of a channel. Every message is queued until the
+ * subscriber reads it, the callback only wakes the subscriber up.
+ */
+typedef struct {
+    struct k_msgq queue; /**< Messages not read yet */
+    uint8_t buffer[SUBSCRIBER_QUEUE_DEPTH * sizeof(zbus_message_variant_t)]; /**< Queue storage */
+    void *state; /**< State passed to the callback */
+    zbus_backend_callback_t callback; /**< Callback called when a message is queued */
+    uint32_t id; /**< Channel index */
+    uint32_t drops; /**< Messages lost because the queue was full */
+    zbus_backend_index_t next; /**< Link to the next subscriber of the channel */
+    bool is_behind; /**< Flag set while the queue is full, to warn once per overrun */
+} zbus_backend_subscriber_t;
+
+/**
+ * @brief Pool of persistent subscribers, in subscriber_pool_objects. The subscription
+ * handles carry the generation of the subscriber, so a handle kept after unsubscribing
+ * does not reach the next subscription of the slot.
+ */
+RART_POOL_DEFINE(subscriber_pool, zbus_backend_subscriber_t, NUM_OF_SUBSCRIBERS,
+                 RART_POOL_GENERATIONS(NUM_OF_SUBSCRIBERS));
+
+/**
+ * @brief Get the subscriber of a subscription handle
+ *
+ * @param handle Subscription handle
+ * @return zbus_backend_subscriber_t* Subscriber, NULL if the handle is invalid or stale.
+ */
+static zbus_backend_subscriber_t *subscriber_get(uint32_t handle);
+
+/**
+ * @brief Link to the first subscriber of each channel, protected by list_lock
+ */
+static zbus_backend_index_t subscriber_head[NUM_OF_CHANNELS];
+#endif
+
+/**
+ * @brief Observer of a set of channels
+ */
+typedef struct {
+    void *state; /**< State passed to the callback */
+    zbus_backend_set_callback_t callback; /**< Callback called with the changed channels */
+    uint32_t mask; /**< Channels observed */
+} zbus_backend_set_observer_t;
+
+/**
+ * @brief Pool of channel set observers
+ */
+static zbus_backend_set_observer_t set_observer_list[NUM_OF_SET_OBSERVERS];
+
+/**
+ * @brief Bitmap of the set observer slots claimed by a registration
+ */
+static ATOMIC_DEFINE(set_observer_used, NUM_OF_SET_OBSERVERS);
+
+/**
+ * @brief Bitmap of the set observers registered. A bit is set once the fields of its
+ * slot are written, and cleared by the dispatch that takes the observer.
+ */
+static ATOMIC_DEFINE(set_observer_ready, NUM_OF_SET_OBSERVERS);
+
+/**
+ * @brief Serializes the batch publications
+ */
+static K_MUTEX_DEFINE(batch_lock);
+
+/**
+ * @brief Thread running a batch publication. The listener calls of its publications
+ * are left to the batch, which dispatches every channel at the end.
+ */
+static k_tid_t batch_owner;
+
+/**
+ * @brief Publisher waiting for a busy channel
+ */
+typedef struct {
+    struct k_work_delayable work; /**< Timeout of the wait and poll of the channel */
+    int64_t deadline; /**< Uptime, in ticks, when the wait expires */
+    void *state; /**< State passed to the callback */
+    zbus_backend_publish_callback_t callback; /**< Callback called when the wait ends */
+    uint32_t id; /**< Channel index */
+    zbus_backend_index_t next; /**< Link to the next waiter of the channel */
+    bool is_used; /**< Flag to check if the waiter is in use */
+    bool is_waiting; /**< Flag to check if the waiter is still linked to the channel */
+    bool is_arming; /**< Flag set while the publisher retries after linking the waiter */
+    bool is_ready; /**< Flag set once the work is initialized */
+} zbus_backend_waiter_t;
+
+/**
+ * @brief Pool of publish waiters. The lists are shared with the work of the waiters and
+ * with the publishers of every thread, so they are protected by waiter_lock.
+ */
+static zbus_backend_waiter_t waiter_list[NUM_OF_PUBLISH_WAITERS];
+
+/**
+ * @brief Link to the first publish waiter of each channel
+ */
+static zbus_backend_index_t waiter_head[NUM_OF_CHANNELS];
+
+/**
+ * @brief Lock of the publish waiter lists and of the publication counters
+ */
+static struct k_spinlock waiter_lock;
+
+/**
+ * @brief Publication counters of each channel, protected by waiter_lock
+ */
+static zbus_backend_publish_stats_t publish_stats[NUM_OF_CHANNELS];
+
+/**
+ * @brief Observers of each channel, so a publication only visits the interested entries.
+ * The lists are changed by the registrations and by the dispatches of every thread, so
+ * they are protected by list_lock.
+ */
+static zbus_backend_list_t channel_list[NUM_OF_CHANNELS];
+
+/**
+ * @brief Lock of the observer and subscriber lists of the channels
  */
-static zbus_backend_entry_t entry_list[NUM_OF_OBSERVERS] = {[0 ... (NUM_OF_OBSERVERS - 1)] = {
-        .state = NULL,
-        .callback = NULL,
-        .id = INVALID_ID,
-        .is_free = true,
-}};
+static struct k_spinlock list_lock;
 
 /**
- * @brief TODO
+ * @brief Take a free entry from the observer pool
  *
- * @return zbus_backend_index_t
+ * @return zbus_backend_index_t Index of the entry, INVALID_INDEX if the pool is exhausted.
  */
 static zbus_backend_index_t search_free_entry();
 
 /**
- * @brief Print a formatted string with background red
+ * @brief Give an entry back to the observer pool
+ *
+ * @param idx Index of the entry
+ */
+static void release_entry(zbus_backend_index_t idx);
+
+/**
+ * @brief Call and release the one-shot observers of a channel
+ *
+ * @param idx Channel index
+ * @param msg Channel message
+ * @param size Message size
+ */
+static void notify_observers(uint32_t idx, void *msg, uint32_t size);
+
+/**
+ * @brief Dispatch the message of a channel to its observers and subscribers
+ *
+ * @param idx Channel index
+ */
+static void dispatch_channel(uint32_t idx);
+
+/**
+ * @brief Call, once, each set observer of the changed channels and release it
  *
- * @param format Formatted string
- * @param ... Variable arguments
+ * @param changed Mask of the changed channels
  */
-static void print_error(const char *format, ...);
+static void notify_set_observers(uint32_t changed);
 
 /**
- * @brief TODO
+ * @brief Call the publishers waiting for a channel, because it became available
  *
- * @param id
- * @param state
- * @param callback
+ * @param idx Channel index
  */
-void rtos_zbus_register_observer(uint32_t id, const void *state, zbus_backend_callback_t callback) {
+static void wake_publishers(uint32_t idx);
+
+/**
+ * @brief Publish a message in a channel without waiting or counting a failure
+ *
+ * @param id Channel index, valid
+ * @param data Message
+ * @param size Message size
+ * @return int32_t 0 if success, errno otherwise.
+ */
+static int32_t publish_message(uint32_t id, const void *data, uint32_t size);
+
+/**
+ * @brief Count a failed publication of a channel
+ *
+ * @param id Channel index
+ */
+static void count_failure(uint32_t id);
+
+/**
+ * @brief Count a dispatch of a channel that could not read its message, as a drop of
+ * each subscriber of the channel too
+ *
+ * @param id Channel index
+ */
+static void count_missed(uint32_t id);
+
+/**
+ * @brief Take a free publish waiter and link it to a channel, arming
+ *
+ * @param id Channel index
+ * @param state Context passed to the callback
+ * @param callback Callback called when the wait ends
+ * @param timeout Maximum wait, in milliseconds, or RTOS_ZBUS_WAIT_FOREVER
+ * @return zbus_backend_waiter_t* Waiter, NULL if the pool is exhausted.
+ */
+static zbus_backend_waiter_t *waiter_claim(uint32_t id, const void *state,
+                                           zbus_backend_publish_callback_t callback,
+                                           uint32_t timeout);
+
+/**
+ * @brief Link a waiter to the list of its channel. Called with waiter_lock held.
+ *
+ * @param waiter Waiter
+ */
+static void waiter_link(zbus_backend_waiter_t *waiter);
+
+/**
+ * @brief Unlink a waiter from the list of its channel. Called with waiter_lock held.
+ *
+ * @param waiter Waiter, linked
+ */
+static void waiter_unlink(zbus_backend_waiter_t *waiter);
+
+/**
+ * @brief Schedule the next run of the work of a waiter: the next poll of the channel or
+ * the deadline, the earliest. Called with waiter_lock held.
+ *
+ * @param waiter Waiter
+ * @param now Uptime, in ticks
+ */
+static void waiter_schedule(zbus_backend_waiter_t *waiter, int64_t now);
+
+/**
+ * @brief Work of the publish waiters: end the wait on the deadline, or wake the
+ * publishers if the channel was released by a claim that does not wake them
+ *
+ * @param work Work of the waiter
+ */
+static void waiter_work(struct k_work *work);
+
+#ifdef CHANNEL_MESSAGE_SIZES
+/**
+ * @brief Check the generated channel sizes against the channels of zbus, so a channel
+ * description out of date with zbus_channels.h stops the boot
+ *
+ * @param dev Unused
+ * @return int 0
+ */
+static int check_message_sizes(const struct device *dev);
+
+SYS_INIT(check_message_sizes, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif
+
+#if NUM_OF_SUBSCRIBERS > 0
+/**
+ * @brief Queue a message to the persistent subscribers of a channel and wake them up
+ *
+ * @param idx Channel index
+ * @param msg Channel message
+ */
+static void notify_subscribers(uint32_t idx, void *msg);
+#endif
+
+/**
+ * @brief Register a one-shot observer of a channel
+ *
+ * @param id Channel index
+ * @param state Context passed to the callback
+ * @param callback Callback called with the next message of the channel
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid, -ENOMEM if there is no
+ * free observer entry.
+ */
+int32_t rtos_zbus_register_observer(uint32_t id, const void *state,
+                                    zbus_backend_callback_t callback) {
+    if (id >= NUM_OF_CHANNELS) {
+        RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "Invalid channel %u\n", id);
+        return -EINVAL;
+    }
+
     zbus_backend_index_t idx = search_free_entry();
 
     if (idx == INVALID_INDEX) {
-        print_error("Invalid index\n");
-        while (1);
+        RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "No observer entry available\n");
+        return -ENOMEM;
+    }
+
+    entry_pool_objects[idx].id = id;
+    entry_pool_objects[idx].callback = callback;
+    entry_pool_objects[idx].state = (void *) state;
+    entry_pool_objects[idx].next = NO_LINK;
+
+    zbus_backend_list_t *list = &channel_list[id];
+    k_spinlock_key_t key      = k_spin_lock(&list_lock);
+
+    if (list->tail == NO_LINK) {
+        list->head = LINK_OF(idx);
+    } else {
+        entry_pool_objects[INDEX_OF(list->tail)].next = LINK_OF(idx);
     }
+    list->tail = LINK_OF(idx);
+    k_spin_unlock(&list_lock, key);
 
-    entry_list[idx].id = id;
-    entry_list[idx].callback = callback;
-    entry_list[idx].state = (void *) state;
-    entry_list[idx].is_free = false;
+    return 0;
 }
 
 /**
- * @brief TODO
+ * @brief Publish a message in a channel without waiting
  *
- * @param id
- * @param data
- * @param size
- * @return
+ * @param id Channel index
+ * @param data Message
+ * @param size Message size
+ * @return int32_t 0 if success, errno otherwise.
  */
 int32_t rtos_zbus_publish(uint32_t id, const void *data, uint32_t size) {
-    return zbus_chan_pub(zbus_chan_get_by_index(id), (void *) data, size, K_NO_WAIT, false);
+    if (id >= NUM_OF_CHANNELS) {
+        return -EINVAL;
+    }
+
+    int32_t ret = publish_message(id, data, size);
+
+    if (ret != 0) {
+        count_failure(id);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Publish a message in a channel, or wait for the channel to become available
+ *
+ * @param id Channel index
+ * @param data Message
+ * @param size Message size
+ * @param state Context passed to the callback
+ * @param callback Callback called with 0 when the channel becomes available, or with
+ * -EAGAIN when the timeout expires
+ * @param timeout Maximum wait, in milliseconds, or RTOS_ZBUS_WAIT_FOREVER
+ * @return int32_t 0 if published, -EINPROGRESS if the callback will be called, errno
+ * otherwise.
+ */
+int32_t rtos_zbus_publish_async(uint32_t id, const void *data, uint32_t size, const void *state,
+                                zbus_backend_publish_callback_t callback, uint32_t timeout) {
+    int32_t ret = rtos_zbus_publish(id, data, size);
+
+    if ((ret != -EBUSY && ret != -EAGAIN) || timeout == 0) {
+        return ret;
+    }
+
+    zbus_backend_waiter_t *waiter = waiter_claim(id, state, callback, timeout);
+
+    if (waiter == NULL) {
+        RART_LOG_WRN(RART_LOG_MODULE_ZBUS, "No publish waiter available\n");
+        return ret;
+    }
+
+    for (;;) {
+        /* The waiter is linked before this retry, so a release after the first attempt
+         * either lets the retry publish or wakes the waiter */
+        ret = publish_message(id, data, size);
+
+        k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+
+        if (ret != -EBUSY && ret != -EAGAIN) {
+            if (waiter->is_waiting) {
+                waiter_unlink(waiter);
+            }
+            waiter->is_used = false;
+            k_spin_unlock(&waiter_lock, key);
+
+            return ret;
+        }
+
+        if (waiter->is_waiting) {
+            waiter->is_arming = false;
+            publish_stats[id].waits++;
+            waiter_schedule(waiter, k_uptime_ticks());
+            k_spin_unlock(&waiter_lock, key);
+
+            return -EINPROGRESS;
+        }
+
+        /* Woken during the retry, by a release the retry did not see */
+        waiter_link(waiter);
+        k_spin_unlock(&waiter_lock, key);
+    }
+}
+
+/**
+ * @brief Get the publication counters of a channel
+ *
+ * @param id Channel index
+ * @param stats Counters of the channel
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid.
+ */
+int32_t rtos_zbus_publish_stats_get(uint32_t id, zbus_backend_publish_stats_t *stats) {
+    if (id >= NUM_OF_CHANNELS || stats == NULL) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+    *stats = publish_stats[id];
+    k_spin_unlock(&waiter_lock, key);
+
+    return 0;
+}
+
+/**
+ * @brief Register a one-shot observer of a set of channels. The callback is called once
+ * on the next dispatch that changes any of the channels, with the mask of the changed
+ * ones, and the observer is released.
+ *
+ * @param mask Channels observed, bit N is the channel N
+ * @param state Context passed to the callback
+ * @param callback Callback called with the changed channels
+ * @return int32_t 0 if success, -EINVAL if the mask is invalid, -ENOMEM if there is no
+ * free set observer.
+ */
+int32_t rtos_zbus_register_set_observer(uint32_t mask, const void *state,
+                                        zbus_backend_set_callback_t callback) {
+    if (mask == 0 || (mask & ~CHANNEL_MASK_ALL) != 0) {
+        RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "Invalid channel mask 0x%x\n", mask);
+        return -EINVAL;
+    }
+
+    int i = rart_bitmap_claim(set_observer_used, NUM_OF_SET_OBSERVERS);
+
+    if (i < 0) {
+        RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "No set observer available\n");
+        return -ENOMEM;
+    }
+
+    zbus_backend_set_observer_t *observer = &set_observer_list[i];
+
+    observer->state = (void *) state;
+    observer->callback = callback;
+    observer->mask = mask;
+
+    /* Published last, the atomic operation orders the fields before it */
+    atomic_set_bit(set_observer_ready, i);
+
+    return 0;
+}
+
+/**
+ * @brief Update several channels and dispatch them in a single pass. Every message is
+ * written before any observer runs, then the observers and subscribers of each channel
+ * are called and each set observer is called once with all the changed channels.
+ *
+ * @param items Channels and messages to publish
+ * @param count Number of items, up to RTOS_ZBUS_BATCH_MAX
+ * @return int32_t 0 if success, -EINVAL if an item is invalid, errno of the first
+ * channel that could not be written otherwise. The channels written are dispatched
+ * even when another one fails.
+ */
+int32_t rtos_zbus_publish_batch(const zbus_backend_batch_item_t *items, uint32_t count) {
+    if (items == NULL || count > RTOS_ZBUS_BATCH_MAX) {
+        return -EINVAL;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (items[i].id >= NUM_OF_CHANNELS ||
+            items[i].size != MESSAGE_SIZE(items[i].id)) {
+            RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "Invalid batch item %u\n", i);
+            return -EINVAL;
+        }
+
+        /* A repeated channel would only dispatch its last message */
+        for (uint32_t j = 0; j < i; ++j) {
+            if (items[j].id == items[i].id) {
+                RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "Channel %u repeated in the batch\n",
+                             items[i].id);
+                return -EINVAL;
+            }
+        }
+    }
+
+    int32_t ret = 0;
+    uint32_t written = 0;
+    uint32_t changed = 0;
+
+    k_mutex_lock(&batch_lock, K_FOREVER);
+    batch_owner = k_current_get();
+
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t err = publish_message(items[i].id, items[i].data, items[i].size);
+
+        if (err != 0) {
+            count_failure(items[i].id);
+            if (ret == 0) {
+                ret = err;
+            }
+            continue;
+        }
+
+        written |= (uint32_t) 1 << i;
+        changed |= CHANNEL_BIT(items[i].id);
+    }
+
+    batch_owner = NULL;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (written & ((uint32_t) 1 << i)) {
+            dispatch_channel(items[i].id);
+        }
+    }
+
+    notify_set_observers(changed);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (written & ((uint32_t) 1 << i)) {
+            wake_publishers(items[i].id);
+        }
+    }
+
+    k_mutex_unlock(&batch_lock);
+
+    return ret;
 }
 
 /**
- * @brief TODO
+ * @brief Dispatch the last message of a channel to its observers
  *
- * @param idx
+ * @param idx Channel index
  */
 void rtos_zbus_default_listener_callback(uint32_t idx) {
-    zbus_message_variant_t msg_data;
+    if (idx >= NUM_OF_CHANNELS) {
+        return;
+    }
+
+    /* A publication of a batch, dispatched with the others when the batch ends */
+    if (batch_owner != NULL && batch_owner == k_current_get()) {
+        return;
+    }
+
+    dispatch_channel(idx);
+    notify_set_observers(CHANNEL_BIT(idx));
+    wake_publishers(idx);
+}
+
+/**
+ * @brief Borrow the message of a channel without copying it. The channel stays claimed
+ * until rtos_zbus_finish is called.
+ *
+ * @param id Channel index
+ * @param msg[out] Address of the channel message
+ * @param size[out] Size of the channel message
+ * @param timeout Timeout to claim the channel, in milliseconds
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid, errno otherwise.
+ */
+int32_t rtos_zbus_borrow(uint32_t id, const void **msg, uint32_t *size, uint32_t timeout) {
+    if (id >= NUM_OF_CHANNELS) {
+        return -EINVAL;
+    }
+
+    struct zbus_channel *channel = zbus_chan_get_by_index(id);
+    int32_t ret = zbus_chan_claim(channel, K_MSEC(timeout));
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    *msg = channel->message;
+    *size = MESSAGE_SIZE(id);
+
+    return 0;
+}
+
+/**
+ * @brief Release a channel borrowed with rtos_zbus_borrow
+ *
+ * @param id Channel index
+ * @return int32_t 0 if success, -EINVAL if the channel is invalid, errno otherwise.
+ */
+int32_t rtos_zbus_finish(uint32_t id) {
+    if (id >= NUM_OF_CHANNELS) {
+        return -EINVAL;
+    }
+
+    int32_t ret = zbus_chan_finish(zbus_chan_get_by_index(id));
+
+    wake_publishers(id);
+
+    return ret;
+}
+
+#if NUM_OF_SUBSCRIBERS > 0
+/**
+ * @brief Subscribe to every message of a channel. Messages are queued for the
+ * subscriber, the callback is called with a NULL message each time one is queued.
+ *
+ * @param id Channel index
+ * @param state Context passed to the callback
+ * @param callback Callback called when a message is queued
+ * @return int32_t Subscription handle if success, -EINVAL if the channel is invalid,
+ * -ENOMEM if there is no free subscriber.
+ */
+int32_t rtos_zbus_subscribe(uint32_t id, const void *state, zbus_backend_callback_t callback) {
+    if (id >= NUM_OF_CHANNELS) {
+        RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "Invalid channel %u\n", id);
+        return -EINVAL;
+    }
+
+    zbus_backend_subscriber_t *sub = rart_pool_get(&subscriber_pool);
+
+    if (sub == NULL) {
+        RART_LOG_ERR(RART_LOG_MODULE_ZBUS, "No subscriber available\n");
+        return -ENOMEM;
+    }
+
+    zbus_backend_index_t idx = rart_pool_index(&subscriber_pool, sub);
+
+    k_msgq_init(&sub->queue, (char *) sub->buffer,
+                MESSAGE_SIZE(id), SUBSCRIBER_QUEUE_DEPTH);
+    sub->state = (void *) state;
+    sub->callback = callback;
+    sub->id = id;
+    sub->drops = 0;
+    sub->is_behind = false;
+
+    k_spinlock_key_t key = k_spin_lock(&list_lock);
+    sub->next = subscriber_head[id];
+    subscriber_head[id] = LINK_OF(idx);
+    k_spin_unlock(&list_lock, key);
+
+    return rart_pool_handle(&subscriber_pool, idx);
+}
+
+/**
+ * @brief Cancel a subscription
+ *
+ * @param handle Subscription handle
+ * @return int32_t 0 if success, -EINVAL if the handle is invalid.
+ */
+int32_t rtos_zbus_unsubscribe(uint32_t handle) {
+    /* Released under the lock, so a second unsubscribe of the handle finds it stale */
+    k_spinlock_key_t key = k_spin_lock(&list_lock);
+    zbus_backend_subscriber_t *sub = subscriber_get(handle);
+
+    if (sub == NULL) {
+        k_spin_unlock(&list_lock, key);
+        return -EINVAL;
+    }
+
+    zbus_backend_index_t *link = &subscriber_head[sub->id];
+    while (&subscriber_pool_objects[INDEX_OF(*link)] != sub) {
+        link = &subscriber_pool_objects[INDEX_OF(*link)].next;
+    }
+    *link = sub->next;
+
+    k_msgq_purge(&sub->queue);
+    rart_pool_put(&subscriber_pool, sub);
+    k_spin_unlock(&list_lock, key);
+
+    return 0;
+}
+
+/**
+ * @brief Read the oldest message queued for a subscriber, without waiting
+ *
+ * @param handle Subscription handle
+ * @param data_out Address of the out message, with the channel message size
+ * @return int32_t 0 if success, -ENOMSG if there is no message, -EINVAL if the handle is
+ * invalid.
+ */
+int32_t rtos_zbus_subscription_recv(uint32_t handle, void *data_out) {
+    zbus_backend_subscriber_t *sub = subscriber_get(handle);
+
+    if (sub == NULL) {
+        return -EINVAL;
+    }
+
+    return k_msgq_get(&sub->queue, data_out, K_NO_WAIT);
+}
+
+/**
+ * @brief Get the number of messages a subscriber lost because it fell behind
+ *
+ * @param handle Subscription handle
+ * @return uint32_t Number of dropped messages, 0 if the handle is invalid.
+ */
+uint32_t rtos_zbus_subscription_drops(uint32_t handle) {
+    zbus_backend_subscriber_t *sub = subscriber_get(handle);
+
+    return (sub == NULL) ? 0 : sub->drops;
+}
+#else
+int32_t rtos_zbus_subscribe(uint32_t id, const void *state, zbus_backend_callback_t callback) {
+    ARG_UNUSED(id);
+    ARG_UNUSED(state);
+    ARG_UNUSED(callback);
+
+    return -ENOTSUP;
+}
+
+int32_t rtos_zbus_unsubscribe(uint32_t handle) {
+    ARG_UNUSED(handle);
+
+    return -ENOTSUP;
+}
+
+int32_t rtos_zbus_subscription_recv(uint32_t handle, void *data_out) {
+    ARG_UNUSED(handle);
+    ARG_UNUSED(data_out);
+
+    return -ENOTSUP;
+}
+
+uint32_t rtos_zbus_subscription_drops(uint32_t handle) {
+    ARG_UNUSED(handle);
+
+    return 0;
+}
+#endif
+
+static void dispatch_channel(uint32_t idx) {
+    k_spinlock_key_t key = k_spin_lock(&list_lock);
+    bool is_observed     = (channel_list[idx].head != NO_LINK);
+#if NUM_OF_SUBSCRIBERS > 0
+    is_observed = is_observed || subscriber_head[idx] != NO_LINK;
+#endif
+    k_spin_unlock(&list_lock, key);
+
+    if (!is_observed) {
+        return;
+    }
+
     struct zbus_channel *channel = zbus_chan_get_by_index(idx);
+    k_timeout_t wait = K_MSEC(CONFIG_RART_ZBUS_DISPATCH_WAIT_MS);
+
+#if defined(CONFIG_RART_ZBUS_ZERO_COPY)
+    int ret = zbus_chan_claim(channel, wait);
+    void *msg = channel->message;
+#else
+    zbus_message_variant_t msg_data;
+    void *msg = &msg_data;
+    int ret = zbus_chan_read(channel, (uint8_t *) &msg_data, MESSAGE_SIZE(idx), wait);
+#endif
 
-    zbus_chan_read(channel, (uint8_t *) &msg_data, channel->message_size, K_NO_WAIT);
+    /* Only detached once the message is read, so the observers wait for the next one */
+    if (ret != 0) {
+        RART_LOG_WRN(RART_LOG_MODULE_ZBUS, "Channel %u busy on dispatch\n", idx);
+        count_missed(idx);
+        return;
+    }
+
+#if NUM_OF_SUBSCRIBERS > 0
+    notify_subscribers(idx, msg);
+#endif
+    notify_observers(idx, msg, MESSAGE_SIZE(idx));
+
+#if defined(CONFIG_RART_ZBUS_ZERO_COPY)
+    zbus_chan_finish(channel);
+#endif
+}
 
-    for (int i = 0; i < NUM_OF_OBSERVERS; ++i) {
-        if (entry_list[i].is_free) {
+static void notify_set_observers(uint32_t changed) {
+    zbus_backend_set_observer_t pending[NUM_OF_SET_OBSERVERS];
+    int count = 0;
+
+    /* Copy and release first: a released slot can be registered again at once, and
+     * observers registered by the callbacks wait for the next dispatch */
+    for (int i = 0; i < NUM_OF_SET_OBSERVERS; ++i) {
+        zbus_backend_set_observer_t *observer = &set_observer_list[i];
+
+        if (!atomic_test_bit(set_observer_ready, i) || (observer->mask & changed) == 0) {
             continue;
         }
 
-        if (entry_list[i].id == idx) {
-            entry_list[i].callback(entry_list[i].state, &msg_data, channel->message_size);
-            entry_list[i].is_free = true;
+        /* Only one dispatch takes the observer */
+        if (!atomic_test_and_clear_bit(set_observer_ready, i)) {
+            continue;
         }
+
+        pending[count] = *observer;
+
+        /* The slot was released and registered again after the mask was read */
+        if ((pending[count].mask & changed) == 0) {
+            atomic_set_bit(set_observer_ready, i);
+            continue;
+        }
+
+        pending[count].mask &= changed;
+        count++;
+        rart_bitmap_release(set_observer_used, i);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        pending[i].callback(pending[i].state, pending[i].mask);
     }
 }
 
-static zbus_backend_index_t search_free_entry() {
-    for (int i = 0; i < NUM_OF_OBSERVERS; ++i) {
-        if (entry_list[i].is_free) {
-            return i;
+static void notify_observers(uint32_t idx, void *msg, uint32_t size) {
+    /* Detach the list, observers registered by the callbacks wait for the next message */
+    k_spinlock_key_t key      = k_spin_lock(&list_lock);
+    zbus_backend_index_t link = channel_list[idx].head;
+
+    channel_list[idx].head = NO_LINK;
+    channel_list[idx].tail = NO_LINK;
+    k_spin_unlock(&list_lock, key);
+
+    while (link != NO_LINK) {
+        zbus_backend_index_t i = INDEX_OF(link);
+
+        link = entry_pool_objects[i].next;
+
+        RART_TRACE(RART_TRACE_WAKE_ZBUS, idx, entry_pool_objects[i].state);
+        entry_pool_objects[i].callback(entry_pool_objects[i].state, msg, size);
+        release_entry(i);
+    }
+}
+
+static void wake_publishers(uint32_t idx) {
+    k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+    zbus_backend_index_t first = NO_LINK;
+    zbus_backend_index_t *tail = &first;
+
+    /* Waiters still arming are only unlinked, their publishers retry by themselves */
+    for (zbus_backend_index_t link = waiter_head[idx]; link != NO_LINK;) {
+        zbus_backend_waiter_t *waiter = &waiter_list[INDEX_OF(link)];
+        zbus_backend_index_t next = waiter->next;
+
+        waiter->is_waiting = false;
+        if (!waiter->is_arming) {
+            *tail = link;
+            tail = &waiter->next;
+        }
+
+        link = next;
+    }
+    *tail = NO_LINK;
+    waiter_head[idx] = NO_LINK;
+    k_spin_unlock(&waiter_lock, key);
+
+    for (zbus_backend_index_t link = first; link != NO_LINK;) {
+        zbus_backend_waiter_t *waiter = &waiter_list[INDEX_OF(link)];
+
+        link = waiter->next;
+
+        k_work_cancel_delayable(&waiter->work);
+        waiter->callback(waiter->state, 0);
+        waiter->is_used = false;
+    }
+}
+
+static int32_t publish_message(uint32_t id, const void *data, uint32_t size) {
+    return zbus_chan_pub(zbus_chan_get_by_index(id), (void *) data, size, K_NO_WAIT, false);
+}
+
+static void count_failure(uint32_t id) {
+    k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+
+    publish_stats[id].failures++;
+    k_spin_unlock(&waiter_lock, key);
+}
+
+static void count_missed(uint32_t id) {
+    k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+
+    publish_stats[id].missed++;
+    k_spin_unlock(&waiter_lock, key);
+
+#if NUM_OF_SUBSCRIBERS > 0
+    key = k_spin_lock(&list_lock);
+    for (zbus_backend_index_t link = subscriber_head[id]; link != NO_LINK;
+         link = subscriber_pool_objects[INDEX_OF(link)].next) {
+        subscriber_pool_objects[INDEX_OF(link)].drops++;
+    }
+    k_spin_unlock(&list_lock, key);
+#endif
+}
+
+static zbus_backend_waiter_t *waiter_claim(uint32_t id, const void *state,
+                                           zbus_backend_publish_callback_t callback,
+                                           uint32_t timeout) {
+    k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+
+    for (int i = 0; i < NUM_OF_PUBLISH_WAITERS; ++i) {
+        zbus_backend_waiter_t *waiter = &waiter_list[i];
+
+        if (waiter->is_used) {
+            continue;
+        }
+
+        /* Initialized once, a work still running from the last wait must stay valid */
+        if (!waiter->is_ready) {
+            k_work_init_delayable(&waiter->work, waiter_work);
+            waiter->is_ready = true;
+        }
+
+        waiter->state = (void *) state;
+        waiter->callback = callback;
+        waiter->id = id;
+        waiter->deadline = (timeout == RTOS_ZBUS_WAIT_FOREVER)
+                                   ? INT64_MAX
+                                   : k_uptime_ticks() + k_ms_to_ticks_ceil64(timeout);
+        waiter->is_used = true;
+        waiter->is_arming = true;
+        waiter_link(waiter);
+        k_spin_unlock(&waiter_lock, key);
+
+        return waiter;
+    }
+
+    k_spin_unlock(&waiter_lock, key);
+
+    return NULL;
+}
+
+static void waiter_link(zbus_backend_waiter_t *waiter) {
+    waiter->next = waiter_head[waiter->id];
+    waiter_head[waiter->id] = LINK_OF(waiter - waiter_list);
+    waiter->is_waiting = true;
+}
+
+static void waiter_unlink(zbus_backend_waiter_t *waiter) {
+    zbus_backend_index_t *link = &waiter_head[waiter->id];
+
+    while (&waiter_list[INDEX_OF(*link)] != waiter) {
+        link = &waiter_list[INDEX_OF(*link)].next;
+    }
+    *link = waiter->next;
+    waiter->is_waiting = false;
+}
+
+static void waiter_schedule(zbus_backend_waiter_t *waiter, int64_t now) {
+    int64_t delay = (waiter->deadline == INT64_MAX) ? INT64_MAX : waiter->deadline - now;
+
+#if CONFIG_RART_ZBUS_WAIT_POLL_MS > 0
+    delay = MIN(delay, (int64_t) k_ms_to_ticks_ceil64(CONFIG_RART_ZBUS_WAIT_POLL_MS));
+#endif
+
+    if (delay != INT64_MAX) {
+        k_work_reschedule(&waiter->work, K_TICKS(MAX(delay, 0)));
+    }
+}
+
+static void waiter_work(struct k_work *work) {
+    struct k_work_delayable *delayable = k_work_delayable_from_work(work);
+    zbus_backend_waiter_t *waiter = CONTAINER_OF(delayable, zbus_backend_waiter_t, work);
+    k_spinlock_key_t key = k_spin_lock(&waiter_lock);
+
+    if (!waiter->is_waiting || waiter->is_arming) {
+        k_spin_unlock(&waiter_lock, key);
+        return;
+    }
+
+    uint32_t id = waiter->id;
+    int64_t now = k_uptime_ticks();
+
+    if (now >= waiter->deadline) {
+        waiter_unlink(waiter);
+        publish_stats[id].timeouts++;
+        k_spin_unlock(&waiter_lock, key);
+
+        waiter->callback(waiter->state, -EAGAIN);
+        waiter->is_used = false;
+        return;
+    }
+
+    waiter_schedule(waiter, now);
+    k_spin_unlock(&waiter_lock, key);
+
+    /* A claim made outside the backend, like a zbus_chan_read of another observer, does
+     * not wake the waiters, so check if the channel is free again */
+    struct zbus_channel *channel = zbus_chan_get_by_index(id);
+
+    if (zbus_chan_claim(channel, K_NO_WAIT) == 0) {
+        zbus_chan_finish(channel);
+        wake_publishers(id);
+    }
+}
+
+#if NUM_OF_SUBSCRIBERS > 0
+static zbus_backend_subscriber_t *subscriber_get(uint32_t handle) {
+    int idx = rart_pool_handle_index(&subscriber_pool, handle);
+
+    return (idx < 0) ? NULL : &subscriber_pool_objects[idx];
+}
+
+static void notify_subscribers(uint32_t idx, void *msg) {
+    uint32_t pending[NUM_OF_SUBSCRIBERS];
+    int count = 0;
+    k_spinlock_key_t key = k_spin_lock(&list_lock);
+
+    /* Queue under the lock and wake after it, by handle: a subscription cancelled in the
+     * meantime, even by one of the callbacks, is neither followed nor woken */
+    for (zbus_backend_index_t link = subscriber_head[idx]; link != NO_LINK;
+         link = subscriber_pool_objects[INDEX_OF(link)].next) {
+        zbus_backend_index_t i = INDEX_OF(link);
+        zbus_backend_subscriber_t *sub = &subscriber_pool_objects[i];
+
+        if (k_msgq_put(&sub->queue, msg, K_NO_WAIT) == 0) {
+            sub->is_behind = false;
+        } else {
+            sub->drops++;
+            if (!sub->is_behind) {
+                sub->is_behind = true;
+                RART_LOG_WRN(RART_LOG_MODULE_ZBUS, "Subscriber %u of channel %u fell behind\n",
+                             i, idx);
+            }
+        }
+
+        pending[count++] = rart_pool_handle(&subscriber_pool, i);
+    }
+    k_spin_unlock(&list_lock, key);
+
+    for (int i = 0; i < count; ++i) {
+        void *state = NULL;
+        zbus_backend_callback_t callback = NULL;
+
+        key = k_spin_lock(&list_lock);
+        zbus_backend_subscriber_t *sub = subscriber_get(pending[i]);
+        if (sub != NULL) {
+            state = sub->state;
+            callback = sub->callback;
+        }
+        k_spin_unlock(&list_lock, key);
+
+        if (callback == NULL) {
+            continue;
         }
+
+        RART_TRACE(RART_TRACE_WAKE_ZBUS, idx, state);
+        callback(state, NULL, 0);
     }
+}
+#endif
+
+#ifdef CHANNEL_MESSAGE_SIZES
+static int check_message_sizes(const struct device *dev) {
+    ARG_UNUSED(dev);
+
+    for (uint32_t i = 0; i < NUM_OF_CHANNELS; ++i) {
+        uint32_t size = zbus_chan_get_by_index(i)->message_size;
+
+        if (channel_message_size[i] != size) {
+            panic("Channel %u has %u bytes in the description and %u in zbus\n", i,
+                  channel_message_size[i], size);
+        }
+    }
+
+    return 0;
+}
+#endif
+
+static zbus_backend_index_t search_free_entry() {
+    zbus_backend_entry_t *entry = rart_pool_get(&entry_pool);
 
-    return INVALID_INDEX;
+    return (entry == NULL) ? INVALID_INDEX : rart_pool_index(&entry_pool, entry);
 }
 
-static void print_error(const char *format, ...) {
-    printk("\x1b[41m");
-    va_list va;
-    va_start(va, format);
-    vprintk(format, va);
-    va_end(va);
-    printk("\x1b[0m");
+static void release_entry(zbus_backend_index_t idx) {
+    rart_pool_put(&entry_pool, &entry_pool_objects[idx]);
 }
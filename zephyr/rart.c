@@ -10,137 +10,365 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <zephyr.h>
 
+#if defined(CONFIG_RART_TRACING)
+#include <tracing/tracing.h>
+#endif
+
+#if defined(CONFIG_SHELL)
+#define RART_SHELL
+#include <shell/shell.h>
+#endif
+
 #include "rart-defines.h"
+#include "rart-pool.h"
+#include "rart.h"
+
+/*
+ * Pool sizes. Each one can be set by the resource manifest of gen_files.py in
+ * rart-defines.h, otherwise it is derived from the number of tasks.
+ */
 
 /**
  * @brief Number of the mutexes
  */
+#ifndef NUM_OF_MUTEXES
 #define NUM_OF_MUTEXES (7 * NUM_OF_TASKS)
+#endif
 
 /**
  * @brief Number of the message queues
  */
+#ifndef NUM_OF_MSGQ
 #define NUM_OF_MSGQ (4 * NUM_OF_TASKS)
+#endif
 
 /**
- * @brief Number of the message queues size
+ * @brief Depth of each message queue. It does not grow with the number of tasks, so the
+ * queue storage stays linear in the number of queues.
  */
-#define NUM_OF_MSG_ITENS (4 * NUM_OF_TASKS)
+#ifndef NUM_OF_MSG_ITENS
+#define NUM_OF_MSG_ITENS 8
+#endif
 
 /**
  * @brief Maximum size of the message queue item
  */
+#ifndef MSG_ITEM_SIZE
 #define MSG_ITEM_SIZE 8
+#endif
 
 /**
- * @brief Total memory of the heap
+ * @brief Number of the timers
  */
-#define HEAP_TOTAL 2048
+#ifndef NUM_OF_TIMERS
+#define NUM_OF_TIMERS NUM_OF_TASKS
+#endif
+
+/**
+ * @brief Size of the timestamp stored with each message queue item
+ */
+#if defined(CONFIG_RART_MSGQ_STATS)
+#define MSGQ_STAMP_SIZE sizeof(uint32_t)
+#else
+#define MSGQ_STAMP_SIZE 0
+#endif
+
+/**
+ * @brief Size of the storage shared by all message queues. Each queue takes only the
+ * room of its real item size, so a smaller pool can be set when the items are small.
+ */
+#ifndef MSGQ_POOL_SIZE
+#define MSGQ_POOL_SIZE (NUM_OF_MSGQ * NUM_OF_MSG_ITENS * (MSG_ITEM_SIZE + MSGQ_STAMP_SIZE))
+#endif
 
 /**
- * @brief Invalid index
+ * @brief Total memory of the heap
  */
-#define INVALID_INDEX ((rart_index_t) -1)
+#ifndef HEAP_TOTAL
+#define HEAP_TOTAL 2048
+#endif
 
 /**
  * @brief Heap definition used by Rust
  */
 K_HEAP_DEFINE(rtos_allocator, HEAP_TOTAL);
 
+BUILD_ASSERT(NUM_OF_MUTEXES < UINT16_MAX && NUM_OF_MSGQ < UINT16_MAX
+                     && NUM_OF_TIMERS < UINT16_MAX,
+             "Pools are limited to 65534 objects");
+
+/**
+ * @brief Try the mutex without waiting before blocking, to detect contention
+ */
+#if defined(CONFIG_RART_TRACING) || defined(CONFIG_RART_MUTEX_PROFILING)
+#define MUTEX_DETECT_CONTENTION
+#endif
+
+/**
+ * @brief Profiling data of a mutex, in cycles
+ */
+struct rart_mutex_profile {
+    uint32_t acquisitions; /**< Number of successful locks */
+    atomic_t contended;    /**< Number of locks that found the mutex busy, held or not */
+    uint64_t wait_total;   /**< Total wait time */
+    uint32_t wait_max;     /**< Longest wait time */
+    uint64_t hold_total;   /**< Total hold time */
+    uint32_t hold_max;     /**< Longest hold time */
+    uint32_t locked_at;    /**< Cycle of the outermost lock */
+    k_tid_t owner;         /**< Task holding the mutex */
+};
+
+/**
+ * @brief Statistics of a message queue, in cycles
+ */
+struct rart_msgq_stats {
+    uint32_t sent;          /**< Number of items sent */
+    uint32_t received;      /**< Number of items received */
+    uint32_t peak_used;     /**< Highest number of items stored */
+    uint32_t full;          /**< Sends on a full queue */
+    uint32_t empty;         /**< Receives on an empty queue */
+    uint64_t blocked_total; /**< Total time blocked */
+    uint64_t latency_total; /**< Total enqueue-to-dequeue latency */
+    uint32_t latency_max;   /**< Highest enqueue-to-dequeue latency */
+};
+
+/**
+ * @brief Mutex of the pool
+ */
+struct rart_mutex {
+#if !defined(RART_STATIC_OBJECTS)
+    struct k_mutex mutex; /**< Zephyr OS mutex. It must be the first field. */
+#endif
+    bool is_init;         /**< Flag to check the mutex initialization. */
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+    struct rart_mutex_profile profile; /**< Contention statistics */
+#endif
+};
+
+/**
+ * @brief Timer of the pool
+ */
+struct rart_timer {
+    const void *state; /**< Reference to state that will be sent in the timer callback. */
+    rart_timer_callback_t callback; /**< Timer callback */
+    int64_t start;     /**< Tick the periods of a periodic timer are counted from */
+    uint64_t count;    /**< Periods of a periodic timer elapsed since start */
+    uint32_t epoch;    /**< Stops of the timer, so an expiry never re-arms a later owner */
+    uint32_t period;   /**< Period of a periodic timer in milliseconds, 0 if one-shot */
+    uint32_t missed;   /**< Periods of a periodic timer expired late */
+    uint8_t policy;    /**< rart_timer_missed_policy_t of a periodic timer */
+#if !defined(RART_STATIC_OBJECTS)
+    struct k_timer timer; /**< Zephyr OS timer */
+#endif
+};
+
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+#if defined(RART_STATIC_OBJECTS)
+#error "CONFIG_RART_POOL_OVERFLOW needs the kernel objects in the pools, drop gen_files.py -S"
+#endif
+
+/**
+ * @brief Allocate a mutex from the heap when the mutex pool is exhausted
+ *
+ * @param size Size of the mutex
+ * @return void* Address of the mutex, NULL if the heap is exhausted.
+ */
+static void *mutex_overflow_alloc(size_t size);
+
+/**
+ * @brief Give a mutex allocated by mutex_overflow_alloc back to the heap
+ *
+ * @param obj[in] Address of the mutex
+ */
+static void mutex_overflow_free(void *obj);
+
+/**
+ * @brief Allocate a timer when the timer pool is exhausted, from the spare timers or
+ * from the heap. A spare keeps its kernel timer untouched, a timer from the heap is
+ * zeroed and initialized.
+ *
+ * @param size Size of the timer
+ * @return void* Address of the timer, NULL if the heap is exhausted.
+ */
+static void *timer_overflow_alloc(size_t size);
+
 /**
- * @brief Type of the user timer callback called inside the Zephyr timer expire callback.
+ * @brief Keep a timer allocated by timer_overflow_alloc as a spare. The kernel still
+ * uses the timer after its expiry function returns, so it goes back to the heap only
+ * once it stayed a spare for a whole TIMER_SPARES_GRACE_MS.
  *
- * @param state State of user timer callback. This state is required by RART-rs
+ * @param obj[in] Address of the timer
  */
-typedef void (*rart_timer_callback_t)(const void *state);
+static void timer_overflow_free(void *obj);
 
 /**
- * @brief Type of the index used in this lib.
+ * @brief Give the spare timers released before the last run back to the heap
+ *
+ * @param work[in] timer_spares_work
+ */
+static void timer_spares_trim(struct k_work *work);
+
+/**
+ * @brief Time a spare timer waits before going back to the heap, in milliseconds
+ */
+#define TIMER_SPARES_GRACE_MS 10
+
+/**
+ * @brief Timers released by timer_overflow_free since the last trim
+ */
+static sys_slist_t timer_spares;
+
+/**
+ * @brief Timers released before the last trim, given back to the heap by the next one
+ */
+static sys_slist_t timer_spares_cold;
+
+/**
+ * @brief Lock of the spare timers
+ */
+static struct k_spinlock timer_spares_lock;
+
+/**
+ * @brief Trim of the spare timers, run while there are spares
+ */
+static K_WORK_DELAYABLE_DEFINE(timer_spares_work, timer_spares_trim);
+
+#define MUTEX_POOL_OVERFLOW RART_POOL_OVERFLOW(mutex_overflow_alloc, mutex_overflow_free)
+#define TIMER_POOL_OVERFLOW RART_POOL_OVERFLOW(timer_overflow_alloc, timer_overflow_free)
+#else
+#define MUTEX_POOL_OVERFLOW
+#define TIMER_POOL_OVERFLOW
+#endif
+
+/**
+ * @brief Pool of mutexes, in mutex_pool_objects
+ */
+RART_POOL_DEFINE(mutex_pool, struct rart_mutex, NUM_OF_MUTEXES, MUTEX_POOL_OVERFLOW);
+
+/**
+ * @brief Pool of timers, in timer_pool_objects
  */
-typedef uint8_t rart_index_t;
+RART_POOL_DEFINE(timer_pool, struct rart_timer, NUM_OF_TIMERS, TIMER_POOL_OVERFLOW);
 
 /**
- * @brief Struct with global variables of the RART-c
+ * @brief Serializes the stop of a periodic timer with its re-arm by the expiry function,
+ * which may run on another core
+ */
+static struct k_spinlock timer_lock;
+
+/**
+ * @brief Struct with global variables of the RART-c. Every field starts as zero, so the
+ * struct is kept in .bss and is neither stored in flash nor copied at boot.
  */
 static struct rart_fields {
     struct {
-        struct k_mutex mutex;  /**< Zephyr OS mutex. */
-        bool is_free;          /**< Flag to check if the mutex is free */
-        bool is_init;          /**< Flag to check the mutex initialization. */
-    } mutexes[NUM_OF_MUTEXES]; /**< List of mutexes */
-    struct {
+        uint8_t pool[MSGQ_POOL_SIZE] __aligned(4); /**< Storage of all message queues */
         struct {
-            uint8_t
-                    buffer[NUM_OF_MSG_ITENS * MSG_ITEM_SIZE]; /**< Message queue storage */
-            struct k_msgq msgq;                           /**< Zephyr OS message queue. */
-        } instance[NUM_OF_MSGQ];                          /**< List of Message Queues */
-        rart_index_t index; /**< Index of the next available message queue */
-        bool is_init;       /**< Flag to check all message queues initialization */
+            struct k_msgq msgq; /**< Zephyr OS message queue. */
+#if defined(CONFIG_RART_MSGQ_STATS)
+            struct rart_msgq_stats stats; /**< Occupancy and latency statistics */
+#endif
+        } instance[NUM_OF_MSGQ]; /**< List of Message Queues */
+        atomic_t index;     /**< Number of message queues handed out */
+        atomic_t used;      /**< Bytes of the pool already taken */
     } msgq;                 /**< Message queue sub-struct */
-    struct {
-        const void
-                *state; /**< Reference to state that will be sent in the timer callback. */
-        rart_timer_callback_t callback; /**< Timer callback */
-        struct k_timer timer;           /**< Zephyr OS timer */
-        bool is_free;                   /**< Flag to check if the mutex is free */
-    } timers[NUM_OF_TASKS];             /**< List of timers */
-} self = {
-        .mutexes = {[0 ...(NUM_OF_MUTEXES - 1)] =
-                {
-                        .mutex   = {},
-                        .is_free = true,
-                        .is_init = false,
-                }},
-        .msgq =
-                {
-                        .index    = 0,
-                        .is_init  = false,
-                        .instance = {[0 ...(NUM_OF_MSGQ - 1)] =
-                                {
-                                        .msgq   = {},
-                                        .buffer = {0},
-                                }},
-                },
-        .timers = {[0 ...(NUM_OF_TASKS - 1)] =
-                {
-                        .state    = NULL,
-                        .callback = NULL,
-                        .timer    = {},
-                        .is_free  = true,
-                }},
-};
+} self;
 
 /**
  * @brief Search a timer by its address.
  *
  * @param timer_id[in] Timer address
- * @return rart_index_t Index of the timer.
+ * @return struct rart_timer* Timer, NULL if it is unknown.
  */
-static rart_index_t search_timer(struct k_timer *timer_id);
+static struct rart_timer *search_timer(struct k_timer *timer_id);
 
 /**
  * @brief Search the next timer free
  *
- * @return rart_index_t Index of the next free timer
+ * @return struct rart_timer* Next free timer, NULL if there is none.
  */
-static rart_index_t search_free_timer();
+static struct rart_timer *search_free_timer();
 
 /**
  * @brief Search the next free mutex
  *
- * @return rart_index_t Index of the next free mutex
+ * @return struct rart_mutex* Next free mutex, NULL if there is none.
  */
-static rart_index_t search_free_mutex();
+static struct rart_mutex *search_free_mutex();
 
 /**
  * @brief Search the mutex by its address
  *
  * @param mutex[in] Mutex address
- * @return rart_index_t Index of the mutex.
+ * @return struct rart_mutex* Mutex, NULL if it is unknown.
+ */
+static struct rart_mutex *search_mutex(struct k_mutex *mutex);
+
+#if defined(MUTEX_DETECT_CONTENTION)
+/**
+ * @brief Get the identifier of a mutex by its address
+ *
+ * @param mutex[in] Mutex address
+ * @return uint32_t Index of the mutex in the pool, NUM_OF_MUTEXES or more for a mutex
+ * taken from the heap.
  */
-static rart_index_t search_mutex(struct k_mutex *mutex);
+static uint32_t mutex_index(struct k_mutex *mutex);
+#endif
+
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+/**
+ * @brief Account a lock operation in the mutex statistics
+ *
+ * @param mutex[in] Mutex address
+ * @param ret Result of the lock operation
+ * @param contended True if the mutex was busy when the lock started
+ * @param start Cycle when the lock started
+ */
+static void mutex_profile_lock(struct k_mutex *mutex, int32_t ret, bool contended,
+                               uint32_t start);
+
+/**
+ * @brief Account the release of a mutex in the mutex statistics
+ *
+ * @param mutex[in] Mutex address
+ */
+static void mutex_profile_unlock(struct k_mutex *mutex);
+#endif
+
+/**
+ * @brief Get the index of a message queue by its address
+ *
+ * @param msgq[in] Message queue address
+ * @return uint32_t Index of the message queue.
+ */
+static uint32_t msgq_index(struct k_msgq *msgq);
+
+#if defined(CONFIG_RART_MSGQ_STATS)
+/**
+ * @brief Account a send operation in the message queue statistics
+ *
+ * @param msgq[in] Message queue address
+ * @param ret Result of the send operation
+ * @param full True if the queue was full when the send started
+ * @param start Cycle when the send started
+ */
+static void msgq_stats_send(struct k_msgq *msgq, int32_t ret, bool full, uint32_t start);
+
+/**
+ * @brief Account a receive operation in the message queue statistics
+ *
+ * @param msgq[in] Message queue address
+ * @param ret Result of the receive operation
+ * @param empty True if the queue was empty when the receive started
+ * @param start Cycle when the receive started
+ * @param stamp[in] Timestamp stored with the received item
+ */
+static void msgq_stats_recv(struct k_msgq *msgq, int32_t ret, bool empty,
+                            uint32_t start, const uint8_t *stamp);
+#endif
 
 /**
  * @brief Callback called when Zephyr timer expire
@@ -149,6 +377,110 @@ static rart_index_t search_mutex(struct k_mutex *mutex);
  */
 static void default_callback(struct k_timer *timer_id);
 
+/**
+ * @brief Arm a periodic timer for its next period, applying its missed-tick policy
+ *
+ * @param entry[in,out] Periodic timer
+ */
+static void timer_periodic_arm(struct rart_timer *entry);
+
+/**
+ * @brief Kernel object of a mutex or timer of the pool. With RART_STATIC_OBJECTS they
+ * are defined by gen_files.py in rart-objects.h and initialized at build time.
+ */
+#if defined(RART_STATIC_OBJECTS)
+#include "rart-objects.h"
+
+BUILD_ASSERT(ARRAY_SIZE(rart_mutexes) == NUM_OF_MUTEXES, "Regenerate rart-objects.h");
+BUILD_ASSERT(ARRAY_SIZE(rart_timers) == NUM_OF_TIMERS, "Regenerate rart-objects.h");
+
+#define MUTEX(idx) (rart_mutexes[idx])
+#define TIMER(idx) (rart_timers[idx])
+#define MUTEX_OF(entry) MUTEX(rart_pool_index(&mutex_pool, entry))
+#define TIMER_OF(entry) TIMER(rart_pool_index(&timer_pool, entry))
+#else
+#define MUTEX(idx) (&mutex_pool_objects[idx].mutex)
+#define TIMER(idx) (&timer_pool_objects[idx].timer)
+#define MUTEX_OF(entry) (&(entry)->mutex)
+#define TIMER_OF(entry) (&(entry)->timer)
+#endif
+
+/**
+ * @brief Stored runtime log level of a module never set, which uses CONFIG_RART_LOG_LEVEL.
+ * The other values are the level plus one, so the array starts as zero and is kept in
+ * .bss.
+ */
+#define LOG_LEVEL_DEFAULT 0
+
+/**
+ * @brief Runtime log level of each module, LOG_LEVEL_DEFAULT or the level plus one
+ */
+static uint8_t log_levels[RART_LOG_MODULE_COUNT];
+
+/**
+ * @brief Print a formatted string prefixed by the level tag
+ *
+ * @param level Level of the message
+ * @param format Formatted string
+ * @param va Variable arguments
+ */
+static void log_vprint(uint8_t level, const char *format, va_list va);
+
+void rart_log_print(uint8_t level, const char *format, ...) {
+    va_list va;
+    va_start(va, format);
+    log_vprint(level, format, va);
+    va_end(va);
+}
+
+void rtos_log_level_set(uint32_t module, uint8_t level) {
+    if (module >= RART_LOG_MODULE_COUNT) {
+        return;
+    }
+
+    /* Clamped, so the stored value never wraps to LOG_LEVEL_DEFAULT */
+    log_levels[module] = ((level > RART_LOG_LEVEL_DBG) ? RART_LOG_LEVEL_DBG : level) + 1;
+}
+
+uint8_t rtos_log_level_get(uint32_t module) {
+    if (module >= RART_LOG_MODULE_COUNT) {
+        return RART_LOG_LEVEL_NONE;
+    }
+
+    if (log_levels[module] == LOG_LEVEL_DEFAULT) {
+        return CONFIG_RART_LOG_LEVEL;
+    }
+
+    return log_levels[module] - 1;
+}
+
+#if defined(CONFIG_RART_TRACING)
+void rart_trace_event(rart_trace_event_t event, uint32_t arg0, uint32_t arg1) {
+    static const char *const names[RART_TRACE_EVENT_COUNT] = {
+            [RART_TRACE_POLL_START]      = "rart_poll_start",
+            [RART_TRACE_POLL_END]        = "rart_poll_end",
+            [RART_TRACE_WAKE_TIMER]      = "rart_wake_timer",
+            [RART_TRACE_WAKE_MSGQ]       = "rart_wake_msgq",
+            [RART_TRACE_WAKE_ZBUS]       = "rart_wake_zbus",
+            [RART_TRACE_MUTEX_CONTENDED] = "rart_mutex_contended",
+    };
+
+    if (event >= RART_TRACE_EVENT_COUNT) {
+        return;
+    }
+
+    sys_trace_named_event(names[event], arg0, arg1);
+}
+#endif
+
+void rtos_trace_poll_start(uint32_t task) {
+    RART_TRACE(RART_TRACE_POLL_START, task, 0);
+}
+
+void rtos_trace_poll_end(uint32_t task) {
+    RART_TRACE(RART_TRACE_POLL_END, task, 0);
+}
+
 /**
  * @brief Print a formatted string with background red
  *
@@ -156,11 +488,16 @@ static void default_callback(struct k_timer *timer_id);
  * @param ... Variable arguments
  */
 void print_error(const char *format, ...) {
-    printk("[err]");
+#if RART_LOG_LEVEL_ERR <= CONFIG_RART_LOG_LEVEL
+    if (!RART_LOG_ENABLED(RART_LOG_MODULE_RUST, RART_LOG_LEVEL_ERR)) {
+        return;
+    }
+
     va_list va;
     va_start(va, format);
-    vprintk(format, va);
+    log_vprint(RART_LOG_LEVEL_ERR, format, va);
     va_end(va);
+#endif
 }
 
 /**
@@ -170,11 +507,16 @@ void print_error(const char *format, ...) {
  * @param ... Variable arguments
  */
 void log_fn(const char *format, ...) {
-    printk("[log]");
+#if RART_LOG_LEVEL_INF <= CONFIG_RART_LOG_LEVEL
+    if (!RART_LOG_ENABLED(RART_LOG_MODULE_RUST, RART_LOG_LEVEL_INF)) {
+        return;
+    }
+
     va_list va;
     va_start(va, format);
-    vprintk(format, va);
+    log_vprint(RART_LOG_LEVEL_INF, format, va);
     va_end(va);
+#endif
 }
 
 /**
@@ -184,7 +526,7 @@ void log_fn(const char *format, ...) {
  * @param line The line
  */
 void trace_fn(const char *file, uint32_t line) {
-    printk("[trace]%s:%d\n", file, line);
+    RART_LOG_DBG(RART_LOG_MODULE_RUST, "%s:%d\n", file, line);
 }
 
 /**
@@ -227,14 +569,14 @@ void panic(const char *format, ...) {
  * @return void* Zephyr mutex C reference
  */
 void *rtos_mutex_new() {
-    rart_index_t idx = search_free_mutex();
+    struct rart_mutex *entry = search_free_mutex();
 
-    if (idx == INVALID_INDEX) {
-        print_error("No mutex available\n");
+    if (entry == NULL) {
+        RART_LOG_ERR(RART_LOG_MODULE_MUTEX, "No mutex available\n");
         return NULL;
     }
 
-    return &self.mutexes[idx].mutex;
+    return MUTEX_OF(entry);
 }
 
 /**
@@ -243,13 +585,13 @@ void *rtos_mutex_new() {
  * @param mutex[in] Zephyr mutex C reference
  */
 void rtos_mutex_del(void *mutex) {
-    rart_index_t idx = search_mutex(mutex);
+    struct rart_mutex *entry = search_mutex(mutex);
 
-    if (idx == INVALID_INDEX) {
+    if (entry == NULL) {
         return;
     }
 
-    self.mutexes[idx].is_free = true;
+    rart_pool_put(&mutex_pool, entry);
 }
 
 /**
@@ -260,7 +602,27 @@ void rtos_mutex_del(void *mutex) {
  * @return int32_t 0 if success, errno otherwise.
  */
 int32_t rtos_mutex_lock(void *mutex, uint32_t timeout) {
+#if defined(MUTEX_DETECT_CONTENTION)
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+    uint32_t start = k_cycle_get_32();
+#endif
+    int32_t ret    = k_mutex_lock(mutex, K_NO_WAIT);
+    bool contended = (ret == -EBUSY);
+
+    if (contended && timeout != 0) {
+        RART_TRACE(RART_TRACE_MUTEX_CONTENDED, mutex_index(mutex),
+                   ((struct k_mutex *) mutex)->owner);
+        ret = k_mutex_lock(mutex, K_MSEC(timeout));
+    }
+
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+    mutex_profile_lock(mutex, ret, contended, start);
+#endif
+
+    return ret;
+#else
     return k_mutex_lock(mutex, K_MSEC(timeout));
+#endif
 }
 
 /**
@@ -270,26 +632,92 @@ int32_t rtos_mutex_lock(void *mutex, uint32_t timeout) {
  * @return int32_t 0 if success, errno otherwise.
  */
 int32_t rtos_mutex_unlock(void *mutex) {
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+    mutex_profile_unlock(mutex);
+#endif
+
     return k_mutex_unlock(mutex);
 }
 
+int32_t rtos_mutex_stats_get(uint32_t idx, rart_mutex_stats_t *stats) {
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+    if (idx >= NUM_OF_MUTEXES || stats == NULL) {
+        return -EINVAL;
+    }
+
+    struct rart_mutex_profile *profile = &mutex_pool_objects[idx].profile;
+
+    stats->acquisitions  = profile->acquisitions;
+    stats->contended     = atomic_get(&profile->contended);
+    stats->wait_total_us = k_cyc_to_us_floor64(profile->wait_total);
+    stats->wait_max_us   = k_cyc_to_us_floor32(profile->wait_max);
+    stats->hold_total_us = k_cyc_to_us_floor64(profile->hold_total);
+    stats->hold_max_us   = k_cyc_to_us_floor32(profile->hold_max);
+    stats->owner         = profile->owner;
+
+    return 0;
+#else
+    ARG_UNUSED(idx);
+    ARG_UNUSED(stats);
+
+    return -ENOTSUP;
+#endif
+}
+
+void rtos_mutex_stats_reset(void) {
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        struct rart_mutex_profile *profile = &mutex_pool_objects[i].profile;
+        k_tid_t owner                      = profile->owner;
+        uint32_t locked_at                 = profile->locked_at;
+
+        memset(profile, 0, sizeof(*profile));
+        profile->owner     = owner;
+        profile->locked_at = locked_at;
+    }
+#endif
+}
+
 /**
- * @brief Get a new Zephyr message queue in the list
+ * @brief Get a new Zephyr message queue in the list. A queue is never handed out twice,
+ * since its owner may still use it or have threads blocked on it, see rart.h. Its storage
+ * is carved from the pool for its item size, so it could not be given back either.
  *
  * @param data_size Item size of the message queue
- * @return void* Zephyr message queue C reference
+ * @return void* Zephyr message queue C reference, NULL if the item size is not supported,
+ * every queue was handed out or the storage is exhausted.
  */
 void *rtos_msgq_new(size_t data_size) {
-    if (!self.msgq.is_init) {
-        self.msgq.is_init = true;
-        for (int i = 0; i < NUM_OF_MSGQ; ++i) {
-            k_msgq_init(&self.msgq.instance[i].msgq, self.msgq.instance[i].buffer,
-                        data_size, NUM_OF_MSG_ITENS);
-        }
+    if (data_size > MSG_ITEM_SIZE) {
+        RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "Message queue item too big\n");
+        return NULL;
     }
 
-    void *msgq = &self.msgq.instance[self.msgq.index].msgq;
-    self.msgq.index = (self.msgq.index >= NUM_OF_MSGQ - 1) ? 0 : (self.msgq.index + 1);
+    size_t item_size = data_size + MSGQ_STAMP_SIZE;
+    size_t size      = NUM_OF_MSG_ITENS * item_size;
+    atomic_val_t used;
+    atomic_val_t idx;
+
+    /* Storage first: if no queue is left afterwards, the storage is never needed again */
+    do {
+        used = atomic_get(&self.msgq.used);
+        if (used + size > MSGQ_POOL_SIZE) {
+            RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "No message queue storage\n");
+            return NULL;
+        }
+    } while (!atomic_cas(&self.msgq.used, used, used + size));
+
+    do {
+        idx = atomic_get(&self.msgq.index);
+        if (idx >= NUM_OF_MSGQ) {
+            RART_LOG_ERR(RART_LOG_MODULE_MSGQ, "No message queue available\n");
+            return NULL;
+        }
+    } while (!atomic_cas(&self.msgq.index, idx, idx + 1));
+
+    struct k_msgq *msgq = &self.msgq.instance[idx].msgq;
+
+    k_msgq_init(msgq, (char *) &self.msgq.pool[used], item_size, NUM_OF_MSG_ITENS);
 
     return msgq;
 }
@@ -303,7 +731,28 @@ void *rtos_msgq_new(size_t data_size) {
  * @return int32_t 0 if success, errno otherwise.
  */
 int32_t rtos_msgq_send(void *msgq, const void *data, uint32_t timeout) {
-    return k_msgq_put(msgq, data, K_MSEC(timeout));
+#if defined(CONFIG_RART_MSGQ_STATS)
+    uint8_t item[MSG_ITEM_SIZE + MSGQ_STAMP_SIZE];
+    size_t data_size = ((struct k_msgq *) msgq)->msg_size - MSGQ_STAMP_SIZE;
+    bool full        = (k_msgq_num_free_get(msgq) == 0);
+    uint32_t start   = k_cycle_get_32();
+
+    memcpy(item, data, data_size);
+    memcpy(&item[data_size], &start, MSGQ_STAMP_SIZE);
+    data = item;
+#endif
+
+    int32_t ret = k_msgq_put(msgq, data, K_MSEC(timeout));
+
+#if defined(CONFIG_RART_MSGQ_STATS)
+    msgq_stats_send(msgq, ret, full, start);
+#endif
+
+    if (ret == 0) {
+        RART_TRACE(RART_TRACE_WAKE_MSGQ, msgq_index(msgq), k_msgq_num_used_get(msgq));
+    }
+
+    return ret;
 }
 
 /**
@@ -315,17 +764,83 @@ int32_t rtos_msgq_send(void *msgq, const void *data, uint32_t timeout) {
  * @return int32_t 0 if success, errno otherwise.
  */
 int32_t rtos_msgq_recv(void *msgq, void *data_out, uint32_t timeout) {
+#if defined(CONFIG_RART_MSGQ_STATS)
+    uint8_t item[MSG_ITEM_SIZE + MSGQ_STAMP_SIZE];
+    size_t data_size = ((struct k_msgq *) msgq)->msg_size - MSGQ_STAMP_SIZE;
+    bool empty       = (k_msgq_num_used_get(msgq) == 0);
+    uint32_t start   = k_cycle_get_32();
+    int32_t ret      = k_msgq_get(msgq, item, K_MSEC(timeout));
+
+    if (ret == 0) {
+        memcpy(data_out, item, data_size);
+    }
+    msgq_stats_recv(msgq, ret, empty, start, &item[data_size]);
+
+    return ret;
+#else
     return k_msgq_get(msgq, data_out, K_MSEC(timeout));
+#endif
+}
+
+int32_t rtos_msgq_stats_get(uint32_t idx, rart_msgq_stats_t *stats) {
+#if defined(CONFIG_RART_MSGQ_STATS)
+    if (idx >= NUM_OF_MSGQ || stats == NULL) {
+        return -EINVAL;
+    }
+
+    struct rart_msgq_stats *msgq_stats = &self.msgq.instance[idx].stats;
+
+    stats->sent             = msgq_stats->sent;
+    stats->received         = msgq_stats->received;
+    stats->peak_used        = msgq_stats->peak_used;
+    stats->full             = msgq_stats->full;
+    stats->empty            = msgq_stats->empty;
+    stats->blocked_total_us = k_cyc_to_us_floor64(msgq_stats->blocked_total);
+    stats->latency_total_us = k_cyc_to_us_floor64(msgq_stats->latency_total);
+    stats->latency_max_us   = k_cyc_to_us_floor32(msgq_stats->latency_max);
+
+    return 0;
+#else
+    ARG_UNUSED(idx);
+    ARG_UNUSED(stats);
+
+    return -ENOTSUP;
+#endif
+}
+
+void rtos_msgq_stats_reset(void) {
+#if defined(CONFIG_RART_MSGQ_STATS)
+    for (int i = 0; i < NUM_OF_MSGQ; ++i) {
+        memset(&self.msgq.instance[i].stats, 0, sizeof(self.msgq.instance[i].stats));
+    }
+#endif
+}
+
+int32_t rtos_pool_stats_get(rart_pool_id_t pool, rart_pool_stats_t *stats) {
+    static struct rart_pool *const pools[RART_POOL_COUNT] = {
+            [RART_POOL_MUTEX] = &mutex_pool,
+            [RART_POOL_TIMER] = &timer_pool,
+    };
+
+    if (pool >= RART_POOL_COUNT || stats == NULL) {
+        return -EINVAL;
+    }
+
+    rart_pool_stats_get(pools[pool], stats);
+
+    return 0;
 }
 
 /**
  * @brief Initialize all Zephyr timers
  */
 void rtos_timer_init() {
-    for (int i = 0; i < NUM_OF_TASKS; ++i) {
-        self.timers[i].is_free = true;
-        k_timer_init(&self.timers[i].timer, default_callback, NULL);
+    rart_pool_reset(&timer_pool);
+#if !defined(RART_STATIC_OBJECTS)
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        k_timer_init(TIMER(i), default_callback, NULL);
     }
+#endif
 }
 
 /**
@@ -337,16 +852,67 @@ void rtos_timer_init() {
  */
 void rtos_timer_reschedule(rart_timer_callback_t callback, const void *state,
                            uint32_t timeout) {
-    rart_index_t idx = search_free_timer();
+    struct rart_timer *entry = search_free_timer();
 
-    if (idx == INVALID_INDEX) {
-        print_error("Invalid index\n");
+    if (entry == NULL) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "No timer available\n");
         while (1);
     }
-    self.timers[idx].callback = callback;
-    self.timers[idx].state = state;
+    entry->callback = callback;
+    entry->state    = state;
+    entry->period   = 0;
 
-    k_timer_start(&self.timers[idx].timer, K_MSEC(timeout), K_NO_WAIT);
+    k_timer_start(TIMER_OF(entry), K_MSEC(timeout), K_NO_WAIT);
+}
+
+void *rtos_timer_periodic_start(rart_timer_callback_t callback, const void *state,
+                                uint32_t period, rart_timer_missed_policy_t policy) {
+    if (period == 0 || policy > RART_TIMER_MISSED_DELAY) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "Invalid periodic timer\n");
+        return NULL;
+    }
+
+    struct rart_timer *entry = search_free_timer();
+
+    if (entry == NULL) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "No timer available\n");
+        return NULL;
+    }
+    entry->callback = callback;
+    entry->state    = state;
+    entry->period   = period;
+    entry->policy   = policy;
+    entry->missed   = 0;
+    entry->count    = 0;
+    entry->start    = k_uptime_ticks();
+
+    timer_periodic_arm(entry);
+
+    return TIMER_OF(entry);
+}
+
+void rtos_timer_periodic_stop(void *timer) {
+    struct rart_timer *entry = search_timer(timer);
+
+    k_spinlock_key_t key = k_spin_lock(&timer_lock);
+
+    if (entry == NULL || entry->period == 0) {
+        k_spin_unlock(&timer_lock, key);
+        return;
+    }
+
+    k_timer_stop(timer);
+    entry->period = 0;
+    entry->epoch++;
+    k_spin_unlock(&timer_lock, key);
+
+    rart_pool_put(&timer_pool, entry);
+}
+
+uint32_t rtos_timer_periodic_missed(void *timer) {
+    struct rart_timer *entry = search_timer(timer);
+
+    return (entry == NULL) ? 0 : entry->missed;
 }
 
 /**
@@ -359,7 +925,7 @@ void rtos_timer_reschedule(rart_timer_callback_t callback, const void *state,
 const void *heap_alloc(size_t align, size_t bytes) {
     void *ptr = k_heap_aligned_alloc(&rtos_allocator, align, bytes, K_NO_WAIT);
     if (ptr == NULL) {
-        printk("Allocation error\n");
+        RART_LOG_ERR(RART_LOG_MODULE_HEAP, "Allocation error\n");
         while (1);
     }
     return ptr;
@@ -374,61 +940,445 @@ void heap_free(const void *mem) {
     k_heap_free(&rtos_allocator, (void *) mem);
 }
 
-static rart_index_t search_timer(struct k_timer *timer_id) {
-    for (int i = 0; i < NUM_OF_TASKS; ++i) {
-        if (&self.timers[i].timer == timer_id) {
-            return i;
+static struct rart_timer *search_timer(struct k_timer *timer_id) {
+#if defined(RART_STATIC_OBJECTS)
+    for (int i = 0; i < NUM_OF_TIMERS; ++i) {
+        if (TIMER(i) == timer_id) {
+            return &timer_pool_objects[i];
         }
     }
 
-    return INVALID_INDEX;
+    return NULL;
+#else
+    struct rart_timer *entry = CONTAINER_OF(timer_id, struct rart_timer, timer);
+
+    return rart_pool_contains(&timer_pool, entry) ? entry : NULL;
+#endif
 }
 
-static rart_index_t search_free_mutex() {
-    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
-        if (self.mutexes[i].is_free || !self.mutexes[i].is_init) {
-            self.mutexes[i].is_free = false;
-            if (!self.mutexes[i].is_init) {
-                self.mutexes[i].is_init = true;
-                k_mutex_init(&self.mutexes[i].mutex);
-            }
-
-            return i;
-        }
+static struct rart_mutex *search_free_mutex() {
+    struct rart_mutex *entry = rart_pool_get(&mutex_pool);
+
+    if (entry == NULL) {
+        return NULL;
     }
 
-    return INVALID_INDEX;
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+    if (rart_pool_index(&mutex_pool, entry) < 0) {
+        RART_LOG_WRN(RART_LOG_MODULE_MUTEX, "Mutex pool exhausted, %u taken from the heap\n",
+                     (uint32_t) atomic_get(&mutex_pool.overflowed));
+    }
+#endif
+
+#if !defined(RART_STATIC_OBJECTS)
+    /* Only the task that claimed the slot touches it until it is released */
+    if (!entry->is_init) {
+        entry->is_init = true;
+        k_mutex_init(&entry->mutex);
+    }
+#endif
+
+    return entry;
 }
 
-static rart_index_t search_mutex(struct k_mutex *mutex) {
+static struct rart_mutex *search_mutex(struct k_mutex *mutex) {
+#if defined(RART_STATIC_OBJECTS)
     for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
-        if (&self.mutexes[i].mutex == mutex) {
-            return i;
+        if (MUTEX(i) == mutex) {
+            return &mutex_pool_objects[i];
         }
     }
 
-    return INVALID_INDEX;
+    return NULL;
+#else
+    struct rart_mutex *entry = CONTAINER_OF(mutex, struct rart_mutex, mutex);
+
+    return rart_pool_contains(&mutex_pool, entry) ? entry : NULL;
+#endif
+}
+
+#if defined(MUTEX_DETECT_CONTENTION)
+static uint32_t mutex_index(struct k_mutex *mutex) {
+    return rart_pool_id(&mutex_pool, search_mutex(mutex));
+}
+#endif
+
+#if defined(CONFIG_RART_MUTEX_PROFILING)
+static void mutex_profile_lock(struct k_mutex *mutex, int32_t ret, bool contended,
+                               uint32_t start) {
+    struct rart_mutex *entry = search_mutex(mutex);
+
+    if (entry == NULL) {
+        return;
+    }
+
+    struct rart_mutex_profile *profile = &entry->profile;
+    uint32_t now                       = k_cycle_get_32();
+    uint32_t wait                      = now - start;
+
+    if (contended) {
+        atomic_inc(&profile->contended);
+    }
+
+    if (ret != 0) {
+        return;
+    }
+
+    profile->acquisitions++;
+    profile->wait_total += wait;
+    if (wait > profile->wait_max) {
+        profile->wait_max = wait;
+    }
+
+    /* Zephyr mutexes are recursive, the hold time starts on the outermost lock */
+    if (mutex->lock_count == 1) {
+        profile->locked_at = now;
+        profile->owner     = mutex->owner;
+    }
+}
+
+static void mutex_profile_unlock(struct k_mutex *mutex) {
+    if (mutex->lock_count != 1 || mutex->owner != k_current_get()) {
+        return;
+    }
+
+    struct rart_mutex *entry = search_mutex(mutex);
+
+    if (entry == NULL) {
+        return;
+    }
+
+    struct rart_mutex_profile *profile = &entry->profile;
+    uint32_t hold                      = k_cycle_get_32() - profile->locked_at;
+
+    profile->hold_total += hold;
+    if (hold > profile->hold_max) {
+        profile->hold_max = hold;
+    }
+    profile->owner = NULL;
+}
+#endif
+
+static uint32_t msgq_index(struct k_msgq *msgq) {
+    return ((uint8_t *) msgq - (uint8_t *) &self.msgq.instance[0].msgq)
+           / sizeof(self.msgq.instance[0]);
+}
+
+#if defined(CONFIG_RART_MSGQ_STATS)
+static void msgq_stats_send(struct k_msgq *msgq, int32_t ret, bool full, uint32_t start) {
+    struct rart_msgq_stats *stats = &self.msgq.instance[msgq_index(msgq)].stats;
+
+    if (full) {
+        stats->full++;
+        stats->blocked_total += k_cycle_get_32() - start;
+    }
+
+    if (ret != 0) {
+        return;
+    }
+
+    uint32_t used = k_msgq_num_used_get(msgq);
+
+    stats->sent++;
+    if (used > stats->peak_used) {
+        stats->peak_used = used;
+    }
+}
+
+static void msgq_stats_recv(struct k_msgq *msgq, int32_t ret, bool empty,
+                            uint32_t start, const uint8_t *stamp) {
+    struct rart_msgq_stats *stats = &self.msgq.instance[msgq_index(msgq)].stats;
+    uint32_t now                  = k_cycle_get_32();
+
+    if (empty) {
+        stats->empty++;
+        stats->blocked_total += now - start;
+    }
+
+    if (ret != 0) {
+        return;
+    }
+
+    uint32_t sent_at;
+
+    memcpy(&sent_at, stamp, sizeof(sent_at));
+
+    uint32_t latency = now - sent_at;
+
+    stats->received++;
+    stats->latency_total += latency;
+    if (latency > stats->latency_max) {
+        stats->latency_max = latency;
+    }
 }
+#endif
 
 static void default_callback(struct k_timer *timer_id) {
-    rart_index_t idx = search_timer(timer_id);
+    struct rart_timer *entry = search_timer(timer_id);
 
-    if (idx == INVALID_INDEX) {
-        print_error("Invalid index\n");
+    if (entry == NULL) {
+        RART_LOG_ERR(RART_LOG_MODULE_TIMER, "Invalid index\n");
         while (1);
     }
 
-    self.timers[idx].callback(self.timers[idx].state);
-    self.timers[idx].is_free = true;
+    RART_TRACE(RART_TRACE_WAKE_TIMER, rart_pool_id(&timer_pool, entry), entry->state);
+
+    k_spinlock_key_t key = k_spin_lock(&timer_lock);
+    bool periodic        = (entry->period != 0);
+    uint32_t epoch       = entry->epoch;
+    k_spin_unlock(&timer_lock, key);
+
+    entry->callback(entry->state);
+
+    if (!periodic) {
+        rart_pool_put(&timer_pool, entry);
+        return;
+    }
+
+    /* Not stopped meanwhile, by the callback or another core, nor taken by a new owner */
+    key = k_spin_lock(&timer_lock);
+    if (entry->period != 0 && entry->epoch == epoch) {
+        timer_periodic_arm(entry);
+    }
+    k_spin_unlock(&timer_lock, key);
 }
 
-static rart_index_t search_free_timer() {
-    for (int i = 0; i < NUM_OF_TASKS; ++i) {
-        if (self.timers[i].is_free) {
-            self.timers[i].is_free = false;
-            return i;
+static void timer_periodic_arm(struct rart_timer *entry) {
+    int64_t now      = k_uptime_ticks();
+    uint64_t next    = entry->count + 1;
+    int64_t deadline = entry->start + k_ms_to_ticks_ceil64(next * entry->period);
+
+    /* Deadlines are computed from the start, so the tick rounding does not accumulate */
+    if (deadline <= now) {
+        uint64_t due = k_ticks_to_ms_floor64(now - entry->start) / entry->period + 1;
+
+        switch (entry->policy) {
+        case RART_TIMER_MISSED_BURST:
+            entry->missed++;
+            break;
+        case RART_TIMER_MISSED_SKIP:
+            entry->missed += due - next;
+            next     = due;
+            deadline = entry->start + k_ms_to_ticks_ceil64(next * entry->period);
+            break;
+        default:
+            entry->missed += due - next;
+            entry->start = now;
+            next         = 1;
+            deadline     = now + k_ms_to_ticks_ceil64(entry->period);
+            break;
         }
     }
+    entry->count = next;
+
+#if defined(CONFIG_TIMEOUT_64BIT)
+    k_timer_start(TIMER_OF(entry), K_TIMEOUT_ABS_TICKS(deadline), K_NO_WAIT);
+#else
+    /* The uptime is 64 bit even when k_ticks_t is not, so only the delay is narrowed */
+    int64_t delay = MIN(MAX(deadline - now, 0), INT32_MAX);
 
-    return INVALID_INDEX;
+    k_timer_start(TIMER_OF(entry), K_TICKS((k_ticks_t) delay), K_NO_WAIT);
+#endif
 }
+
+static struct rart_timer *search_free_timer() {
+    struct rart_timer *entry = rart_pool_get(&timer_pool);
+
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+    if (entry != NULL && rart_pool_index(&timer_pool, entry) < 0) {
+        RART_LOG_WRN(RART_LOG_MODULE_TIMER, "Timer pool exhausted, %u taken from the heap\n",
+                     (uint32_t) atomic_get(&timer_pool.overflowed));
+    }
+#endif
+
+    return entry;
+}
+
+#if defined(CONFIG_RART_POOL_OVERFLOW)
+static void *mutex_overflow_alloc(size_t size) {
+    void *obj = k_heap_aligned_alloc(&rtos_allocator, sizeof(uint64_t), size, K_NO_WAIT);
+
+    if (obj != NULL) {
+        memset(obj, 0, size);
+    }
+
+    return obj;
+}
+
+static void mutex_overflow_free(void *obj) {
+    k_heap_free(&rtos_allocator, obj);
+}
+
+static void *timer_overflow_alloc(size_t size) {
+    k_spinlock_key_t key = k_spin_lock(&timer_spares_lock);
+    sys_snode_t *spare   = sys_slist_get(&timer_spares_cold);
+
+    if (spare == NULL) {
+        spare = sys_slist_get(&timer_spares);
+    }
+    k_spin_unlock(&timer_spares_lock, key);
+
+    /* Restarted like the timers of the pool, never written while the kernel may use it */
+    if (spare != NULL) {
+        return CONTAINER_OF(spare, struct rart_pool_node, node);
+    }
+
+    struct rart_pool_node *node =
+            k_heap_aligned_alloc(&rtos_allocator, sizeof(uint64_t), size, K_NO_WAIT);
+
+    if (node != NULL) {
+        memset(node, 0, size);
+        k_timer_init(&((struct rart_timer *) node->object)->timer, default_callback, NULL);
+    }
+
+    return node;
+}
+
+static void timer_overflow_free(void *obj) {
+    struct rart_pool_node *node = obj;
+    k_spinlock_key_t key        = k_spin_lock(&timer_spares_lock);
+
+    sys_slist_prepend(&timer_spares, &node->node);
+    k_spin_unlock(&timer_spares_lock, key);
+
+    k_work_schedule(&timer_spares_work, K_MSEC(TIMER_SPARES_GRACE_MS));
+}
+
+static void timer_spares_trim(struct k_work *work) {
+    ARG_UNUSED(work);
+
+    /* The cold spares were released at least a whole grace period ago */
+    k_spinlock_key_t key = k_spin_lock(&timer_spares_lock);
+    sys_slist_t cold     = timer_spares_cold;
+
+    timer_spares_cold = timer_spares;
+    sys_slist_init(&timer_spares);
+    bool is_pending = !sys_slist_is_empty(&timer_spares_cold);
+    k_spin_unlock(&timer_spares_lock, key);
+
+    sys_snode_t *spare;
+    while ((spare = sys_slist_get(&cold)) != NULL) {
+        k_heap_free(&rtos_allocator, CONTAINER_OF(spare, struct rart_pool_node, node));
+    }
+
+    if (is_pending) {
+        k_work_schedule(&timer_spares_work, K_MSEC(TIMER_SPARES_GRACE_MS));
+    }
+}
+#endif
+
+static void log_vprint(uint8_t level, const char *format, va_list va) {
+    static const char *const tags[] = {
+            [RART_LOG_LEVEL_NONE] = "",
+            [RART_LOG_LEVEL_ERR]  = "[err]",
+            [RART_LOG_LEVEL_WRN]  = "[wrn]",
+            [RART_LOG_LEVEL_INF]  = "[log]",
+            [RART_LOG_LEVEL_DBG]  = "[trace]",
+    };
+
+    printk("%s", tags[level <= RART_LOG_LEVEL_DBG ? level : RART_LOG_LEVEL_NONE]);
+    vprintk(format, va);
+}
+
+#if defined(RART_SHELL) && defined(CONFIG_RART_MUTEX_PROFILING)
+static int cmd_rart_mutex(const struct shell *sh, size_t argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "reset") != 0) {
+            shell_error(sh, "Unknown argument: %s", argv[1]);
+            return -EINVAL;
+        }
+
+        rtos_mutex_stats_reset();
+        return 0;
+    }
+
+    shell_print(sh, "idx  acquired contended wait_tot(us) wait_max(us) hold_tot(us) "
+                    "hold_max(us) owner");
+
+    for (int i = 0; i < NUM_OF_MUTEXES; ++i) {
+        rart_mutex_stats_t stats;
+
+        rtos_mutex_stats_get(i, &stats);
+        if (stats.acquisitions == 0 && stats.contended == 0) {
+            continue;
+        }
+
+        shell_print(sh, "%-4d %8u %9u %12llu %12u %12llu %12u %p", i, stats.acquisitions,
+                    stats.contended, (unsigned long long) stats.wait_total_us,
+                    stats.wait_max_us, (unsigned long long) stats.hold_total_us,
+                    stats.hold_max_us, stats.owner);
+    }
+
+    return 0;
+}
+#endif
+
+#if defined(RART_SHELL) && defined(CONFIG_RART_MSGQ_STATS)
+static int cmd_rart_msgq(const struct shell *sh, size_t argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "reset") != 0) {
+            shell_error(sh, "Unknown argument: %s", argv[1]);
+            return -EINVAL;
+        }
+
+        rtos_msgq_stats_reset();
+        return 0;
+    }
+
+    shell_print(sh, "idx      sent  received peak  full empty blocked(us) lat_avg(us) "
+                    "lat_max(us)");
+
+    for (int i = 0; i < NUM_OF_MSGQ; ++i) {
+        rart_msgq_stats_t stats;
+
+        rtos_msgq_stats_get(i, &stats);
+        if (stats.sent == 0 && stats.received == 0) {
+            continue;
+        }
+
+        uint64_t latency_avg =
+                stats.received ? stats.latency_total_us / stats.received : 0;
+
+        shell_print(sh, "%-4d %9u %9u %4u %5u %5u %11llu %11llu %11u", i, stats.sent,
+                    stats.received, stats.peak_used, stats.full, stats.empty,
+                    (unsigned long long) stats.blocked_total_us,
+                    (unsigned long long) latency_avg, stats.latency_max_us);
+    }
+
+    return 0;
+}
+#endif
+
+#if defined(RART_SHELL)
+static int cmd_rart_pools(const struct shell *sh, size_t argc, char **argv) {
+    static const char *const names[RART_POOL_COUNT] = {
+            [RART_POOL_MUTEX] = "mutex",
+            [RART_POOL_TIMER] = "timer",
+    };
+
+    shell_print(sh, "pool   size in_use  peak exhausted overflowed");
+
+    for (int i = 0; i < RART_POOL_COUNT; ++i) {
+        rart_pool_stats_t stats;
+
+        rtos_pool_stats_get(i, &stats);
+        shell_print(sh, "%-5s %5u %6u %5u %9u %10u", names[i], stats.size, stats.in_use,
+                    stats.peak, stats.exhausted, stats.overflowed);
+    }
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+        rart_cmds,
+        SHELL_COND_CMD_ARG(CONFIG_RART_MUTEX_PROFILING, mutex, NULL,
+                           "Mutex contention statistics. \"reset\" clears them.",
+                           cmd_rart_mutex, 1, 1),
+        SHELL_COND_CMD_ARG(CONFIG_RART_MSGQ_STATS, msgq, NULL,
+                           "Message queue statistics. \"reset\" clears them.",
+                           cmd_rart_msgq, 1, 1),
+        SHELL_CMD(pools, NULL, "Usage of the object pools.", cmd_rart_pools),
+        SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(rart, &rart_cmds, "RART backend commands", NULL);
+#endif